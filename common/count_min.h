@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 MIRA Project
+ *
+ * Count-Min Sketch - contiguous cache-aligned counter layout
+ *
+ * Shared by the HTTP flood and QUIC detectors. The old per-detector
+ * version allocated each row separately behind a uint32_t** table, so
+ * every update/query paid a dependent pointer load before reaching the
+ * counter. Here the whole counter plane is one flat allocation with
+ * compile-time dimensions (like octosketch.h), so row addressing is pure
+ * arithmetic on a single base pointer and rows never straddle unrelated
+ * heap blocks.
+ */
+
+#ifndef COUNT_MIN_H
+#define COUNT_MIN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_jhash.h>
+
+/* Sketch configuration (same dimensions both detectors used) */
+#define CMS_DEPTH 4            /* Number of hash functions */
+#define CMS_WIDTH 65536        /* Buckets per row (must be power of 2) */
+#define CMS_MASK (CMS_WIDTH - 1)
+
+/* One flat counter plane: counters[d][w] lives at base + d*CMS_WIDTH + w */
+struct count_min_sketch {
+    uint32_t counters[CMS_DEPTH][CMS_WIDTH];
+} __rte_cache_aligned;
+
+/* Allocate a zeroed sketch on a cache-line boundary */
+static inline struct count_min_sketch *cms_init(void)
+{
+    struct count_min_sketch *cms = NULL;
+
+    if (posix_memalign((void **)&cms, RTE_CACHE_LINE_SIZE, sizeof(*cms)) != 0)
+        return NULL;
+
+    memset(cms, 0, sizeof(*cms));
+    return cms;
+}
+
+/* Update Count-Min Sketch */
+static inline void cms_update(struct count_min_sketch *cms, uint32_t item,
+                              uint32_t count)
+{
+    for (uint32_t i = 0; i < CMS_DEPTH; i++) {
+        uint32_t hash = rte_jhash_1word(item, i);
+        uint32_t index = hash & CMS_MASK;
+        cms->counters[i][index] += count;
+    }
+}
+
+/* Query Count-Min Sketch */
+static inline uint32_t cms_query(const struct count_min_sketch *cms,
+                                 uint32_t item)
+{
+    uint32_t min_count = UINT32_MAX;
+
+    for (uint32_t i = 0; i < CMS_DEPTH; i++) {
+        uint32_t hash = rte_jhash_1word(item, i);
+        uint32_t index = hash & CMS_MASK;
+        if (cms->counters[i][index] < min_count)
+            min_count = cms->counters[i][index];
+    }
+
+    return min_count;
+}
+
+/* Reset Count-Min Sketch */
+static inline void cms_reset(struct count_min_sketch *cms)
+{
+    memset(cms->counters, 0, sizeof(cms->counters));
+}
+
+/* Free Count-Min Sketch */
+static inline void cms_free(struct count_min_sketch *cms)
+{
+    free(cms);
+}
+
+#endif /* COUNT_MIN_H */
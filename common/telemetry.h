@@ -0,0 +1,195 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 MIRA Project
+ *
+ * Telemetry - binary stats ring in an mmap'd file
+ *
+ * Detectors publish one fixed-size versioned record per interval with a
+ * plain struct copy under a per-slot seqlock; no formatting happens in
+ * the coordinator loop. A separate reader (telemetry_reader.c) renders
+ * the human view, and the analysis scripts can mmap the ring directly
+ * instead of parsing multi-GB text logs.
+ *
+ * Deliberately DPDK-free so the reader builds with nothing but libc.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TELEMETRY_MAGIC 0x4152494dU    /* "MIRA" */
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_SLOTS 8192           /* power of 2; ~7 min at 50 ms */
+#define TELEMETRY_APP_NAME_LEN 32
+#define TELEMETRY_NUM_AUX 8
+
+/* One published interval. Common fields are shared by every detector;
+ * aux[] carries detector-specific extras (documented per publisher) */
+struct telemetry_record {
+    uint64_t tsc;                      /* TSC at publish */
+    uint64_t wall_ns;                  /* CLOCK_REALTIME, for alignment */
+    uint32_t alert_level;
+    uint32_t reserved;
+    uint64_t total_packets;
+    uint64_t total_bytes;
+    uint64_t baseline_packets;
+    uint64_t attack_packets;
+    uint64_t nic_rx_dropped;
+    double throughput_gbps;
+    double aux[TELEMETRY_NUM_AUX];
+};
+
+struct telemetry_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_slots;
+    uint32_t record_size;              /* Reader sanity check */
+    char app_name[TELEMETRY_APP_NAME_LEN];
+    volatile uint64_t head;            /* Next slot index to write */
+};
+
+/* Per-slot seqlock: odd = write in progress */
+struct telemetry_slot {
+    volatile uint64_t seq;
+    struct telemetry_record rec;
+};
+
+struct telemetry_ctx {
+    struct telemetry_header *hdr;
+    struct telemetry_slot *slots;
+    size_t map_size;
+    int fd;
+};
+
+/* Create (or truncate) the ring file and map it. Returns 0 on success;
+ * on failure the ctx is zeroed and telemetry_publish() becomes a no-op,
+ * so a missing results directory never kills the detector */
+static inline int telemetry_open(struct telemetry_ctx *ctx, const char *path,
+                                 const char *app_name)
+{
+    memset(ctx, 0, sizeof(*ctx));
+
+    size_t size = sizeof(struct telemetry_header) +
+                  (size_t)TELEMETRY_SLOTS * sizeof(struct telemetry_slot);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Warning: Cannot create telemetry ring %s\n", path);
+        return -1;
+    }
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    ctx->hdr = (struct telemetry_header *)map;
+    ctx->slots = (struct telemetry_slot *)(ctx->hdr + 1);
+    ctx->map_size = size;
+    ctx->fd = fd;
+
+    memset(ctx->hdr, 0, sizeof(*ctx->hdr));
+    ctx->hdr->num_slots = TELEMETRY_SLOTS;
+    ctx->hdr->record_size = sizeof(struct telemetry_record);
+    snprintf(ctx->hdr->app_name, TELEMETRY_APP_NAME_LEN, "%s", app_name);
+    ctx->hdr->version = TELEMETRY_VERSION;
+    __sync_synchronize();
+    ctx->hdr->magic = TELEMETRY_MAGIC;   /* Written last: ring is live */
+    return 0;
+}
+
+/* Open an existing ring read-only (reader side) */
+static inline int telemetry_open_ro(struct telemetry_ctx *ctx, const char *path)
+{
+    memset(ctx, 0, sizeof(*ctx));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct telemetry_header)) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    struct telemetry_header *hdr = (struct telemetry_header *)map;
+    if (hdr->magic != TELEMETRY_MAGIC ||
+        hdr->version != TELEMETRY_VERSION ||
+        hdr->record_size != sizeof(struct telemetry_record)) {
+        munmap(map, st.st_size);
+        close(fd);
+        return -1;
+    }
+
+    ctx->hdr = hdr;
+    ctx->slots = (struct telemetry_slot *)(ctx->hdr + 1);
+    ctx->map_size = st.st_size;
+    ctx->fd = fd;
+    return 0;
+}
+
+/* Publish one record: a struct copy under the slot seqlock, nothing more */
+static inline void telemetry_publish(struct telemetry_ctx *ctx,
+                                     const struct telemetry_record *rec)
+{
+    if (ctx->hdr == NULL)
+        return;
+
+    uint64_t head = ctx->hdr->head;
+    struct telemetry_slot *slot = &ctx->slots[head & (TELEMETRY_SLOTS - 1)];
+
+    slot->seq = head * 2 + 1;          /* Odd: write in progress */
+    __sync_synchronize();
+    slot->rec = *rec;
+    __sync_synchronize();
+    slot->seq = head * 2 + 2;
+    ctx->hdr->head = head + 1;
+}
+
+/* Read the record at absolute index (head-1 = newest). Returns 0 on a
+ * consistent read, -1 if the slot was overwritten mid-copy (caller
+ * retries with a newer index) */
+static inline int telemetry_read(const struct telemetry_ctx *ctx,
+                                 uint64_t index, struct telemetry_record *out)
+{
+    const struct telemetry_slot *slot =
+        &ctx->slots[index & (TELEMETRY_SLOTS - 1)];
+
+    uint64_t seq_before = slot->seq;
+    if (seq_before != index * 2 + 2)
+        return -1;
+    __sync_synchronize();
+    *out = slot->rec;
+    __sync_synchronize();
+    return (slot->seq == seq_before) ? 0 : -1;
+}
+
+static inline void telemetry_close(struct telemetry_ctx *ctx)
+{
+    if (ctx->hdr != NULL) {
+        munmap((void *)ctx->hdr, ctx->map_size);
+        close(ctx->fd);
+        memset(ctx, 0, sizeof(*ctx));
+    }
+}
+
+#endif /* TELEMETRY_H */
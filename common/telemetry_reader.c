@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 MIRA Project
+ *
+ * telemetry_reader - render a binary telemetry ring as text
+ *
+ * Usage: telemetry_reader <ring-file> [-f]
+ *   -f   follow mode: poll for new records (like tail -f)
+ *
+ * The detectors only ever do struct copies into the ring; all the
+ * formatting that used to live in their coordinator loops happens here.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "telemetry.h"
+
+static void print_record(const struct telemetry_record *rec, uint64_t index)
+{
+    printf("[%8" PRIu64 "] wall=%.6f alert=%u pkts=%" PRIu64
+           " bytes=%" PRIu64 " baseline=%" PRIu64 " attack=%" PRIu64
+           " nic_drop=%" PRIu64 " gbps=%.2f aux=[",
+           index, rec->wall_ns / 1e9, rec->alert_level,
+           rec->total_packets, rec->total_bytes,
+           rec->baseline_packets, rec->attack_packets,
+           rec->nic_rx_dropped, rec->throughput_gbps);
+    for (int i = 0; i < TELEMETRY_NUM_AUX; i++)
+        printf("%s%.3f", i ? " " : "", rec->aux[i]);
+    printf("]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <ring-file> [-f]\n", argv[0]);
+        return 1;
+    }
+
+    int follow = (argc > 2 && strcmp(argv[2], "-f") == 0);
+
+    struct telemetry_ctx ctx;
+    if (telemetry_open_ro(&ctx, argv[1]) != 0) {
+        fprintf(stderr, "Cannot open telemetry ring %s "
+                        "(missing, or version/record-size mismatch)\n",
+                argv[1]);
+        return 1;
+    }
+
+    printf("# app=%s version=%u slots=%u record_size=%u\n",
+           ctx.hdr->app_name, ctx.hdr->version,
+           ctx.hdr->num_slots, ctx.hdr->record_size);
+
+    /* Start from the oldest record still in the ring */
+    uint64_t head = ctx.hdr->head;
+    uint64_t index = (head > TELEMETRY_SLOTS) ? head - TELEMETRY_SLOTS : 0;
+
+    for (;;) {
+        head = ctx.hdr->head;
+
+        while (index < head) {
+            /* Writer may lap us: skip ahead if the slot was recycled */
+            if (head > TELEMETRY_SLOTS && index < head - TELEMETRY_SLOTS)
+                index = head - TELEMETRY_SLOTS;
+
+            struct telemetry_record rec;
+            if (telemetry_read(&ctx, index, &rec) == 0)
+                print_record(&rec, index);
+            index++;
+        }
+
+        if (!follow)
+            break;
+        usleep(50 * 1000);
+    }
+
+    telemetry_close(&ctx);
+    return 0;
+}
@@ -1,6 +1,6 @@
 /*
  * Detector DDoS con DPDK + Sketches + Feature Extraction
- * Version 2.0
+ * Version 2.1 - multi-worker (RSS) + hashing CRC32 por hardware
  */
 
 #include <rte_eal.h>
@@ -9,6 +9,9 @@
 #include <rte_ip.h>
 #include <rte_tcp.h>
 #include <rte_udp.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_hash_crc.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -17,18 +20,41 @@
 #include <math.h>
 #include <string.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #define RX_RING_SIZE 2048
 #define NUM_MBUFS 16383
 #define MBUF_CACHE_SIZE 512
 #define BURST_SIZE 64
 
+/* Workers RX: RSS reparte por IP origen, así cada IP siempre cae en el
+ * mismo worker y los sketches privados no necesitan atómicos */
+#define NUM_WORKERS 4
+
 #define CM_WIDTH 2048
 #define CM_DEPTH 4
 #define HLL_PRECISION 14
 #define HLL_SIZE (1 << HLL_PRECISION)
 
+/* Modo inline (--forward): RX en puerto 0, TX del tráfico limpio por el
+ * puerto 1, y drop en software de las IPs de la blocklist */
+#define BLOCK_TABLE_SIZE 4096          /* Potencia de 2 */
+#define BLOCK_TABLE_MASK (BLOCK_TABLE_SIZE - 1)
+#define BLOCK_PROBES 4                 /* Sondeo lineal acotado */
+#define BLOCK_CM_THRESHOLD 50000       /* pkts/s de una IP para bloquearla */
+#define BLOCK_MODE_HOLD_SEC 10         /* Ventana de bloqueo tras una alerta */
+
 volatile bool force_quit = false;
 
+static bool forward_mode = false;
+static uint16_t tx_port_id = 1;
+
+/* Ventana de bloqueo: la escribe el coordinador, la leen los workers
+ * (una lectura rota solo retrasa un burst el inicio del bloqueo) */
+static volatile time_t block_mode_until = 0;
+
 typedef struct {
     uint32_t counters[CM_DEPTH][CM_WIDTH];
 } count_min_sketch_t;
@@ -51,45 +77,57 @@ typedef struct {
     uint64_t small_pkts;
 } stats_t;
 
-static inline uint32_t hash_jenkins(const uint8_t *key, size_t len, uint32_t seed) {
-    uint32_t hash = seed;
-    for (size_t i = 0; i < len; i++) {
-        hash += key[i];
-        hash += (hash << 10);
-        hash ^= (hash >> 6);
-    }
-    hash += (hash << 3);
-    hash ^= (hash >> 11);
-    hash += (hash << 15);
-    return hash;
-}
-
-static inline uint32_t hash_murmur(const uint8_t *key, size_t len, uint32_t seed) {
-    const uint32_t m = 0x5bd1e995;
-    uint32_t h = seed ^ len;
-    while (len >= 4) {
-        uint32_t k = *(uint32_t *)key;
-        k *= m;
-        k ^= k >> 24;
-        k *= m;
-        h *= m;
-        h ^= k;
-        key += 4;
-        len -= 4;
-    }
-    return h;
-}
-
 void cm_init(count_min_sketch_t *cm) {
     memset(cm->counters, 0, sizeof(cm->counters));
 }
 
-void cm_update(count_min_sketch_t *cm, uint32_t key) {
+/* Actualiza el sketch y devuelve el minimo tras incrementar: con el
+ * reset por intervalo es la cota superior de pkts/s de esa IP, que es
+ * lo que consulta la blocklist en modo inline. Hash CRC32 por hardware
+ * (SSE4.2) en vez de Jenkins byte a byte: la clave son 4 bytes fijos */
+uint32_t cm_update(count_min_sketch_t *cm, uint32_t key) {
+    uint32_t min_count = UINT32_MAX;
     for (int i = 0; i < CM_DEPTH; i++) {
-        uint32_t hash = hash_jenkins((uint8_t *)&key, sizeof(key), i);
+        uint32_t hash = rte_hash_crc_4byte(key, i);
         uint32_t pos = hash % CM_WIDTH;
         cm->counters[i][pos]++;
+        if (cm->counters[i][pos] < min_count)
+            min_count = cm->counters[i][pos];
+    }
+    return min_count;
+}
+
+/* Blocklist exacta de IPs origen: tabla abierta con sondeo acotado.
+ * 0 = entrada vacia (0.0.0.0 nunca se bloquea). Compartida entre
+ * workers: RSS fija cada IP a un worker, así que las altas de una misma
+ * IP nunca compiten; dos IPs distintas podrían pisarse un hueco vacío y
+ * como mucho se pierde un alta que se repite con el siguiente paquete */
+static uint32_t block_table[BLOCK_TABLE_SIZE];
+static uint32_t blocked_ips = 0;
+
+static inline bool blocklist_check(uint32_t ip) {
+    uint32_t pos = rte_hash_crc_4byte(ip, 0xb10c) & BLOCK_TABLE_MASK;
+    for (int i = 0; i < BLOCK_PROBES; i++) {
+        uint32_t entry = block_table[(pos + i) & BLOCK_TABLE_MASK];
+        if (entry == ip) return true;
+        if (entry == 0) return false;
+    }
+    return false;
+}
+
+static inline void blocklist_add(uint32_t ip) {
+    if (ip == 0 || blocklist_check(ip)) return;
+    uint32_t pos = rte_hash_crc_4byte(ip, 0xb10c) & BLOCK_TABLE_MASK;
+    for (int i = 0; i < BLOCK_PROBES; i++) {
+        uint32_t idx = (pos + i) & BLOCK_TABLE_MASK;
+        if (block_table[idx] == 0) {
+            block_table[idx] = ip;
+            blocked_ips++;
+            return;
+        }
     }
+    /* Tabla llena en esta zona: la IP sigue pasando (mejor falso negativo
+     * que desalojar un bloqueo activo) */
 }
 
 void hll_init(hyperloglog_t *hll) {
@@ -109,7 +147,7 @@ static inline int leading_zeros(uint64_t x) {
 }
 
 void hll_add(hyperloglog_t *hll, uint32_t value) {
-    uint64_t hash = hash_murmur((uint8_t *)&value, sizeof(value), 0x9747b28c);
+    uint64_t hash = rte_hash_crc_4byte(value, 0x9747b28c);
     uint32_t idx = hash & ((1 << HLL_PRECISION) - 1);
     uint64_t w = hash >> HLL_PRECISION;
     uint8_t rho = leading_zeros(w) + 1;
@@ -118,6 +156,25 @@ void hll_add(hyperloglog_t *hll, uint32_t value) {
     }
 }
 
+/* Unión de dos HLL: máximo registro a registro. Es lo que permite que
+ * cada worker mantenga su HLL privado y el coordinador los una por
+ * ventana. Con AVX2 son 32 registros por iteración (16K registros) */
+void hll_merge(hyperloglog_t *dst, const hyperloglog_t *src) {
+#if defined(__AVX2__)
+    for (int i = 0; i < HLL_SIZE; i += 32) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dst->registers[i]);
+        __m256i s = _mm256_loadu_si256((const __m256i *)&src->registers[i]);
+        _mm256_storeu_si256((__m256i *)&dst->registers[i],
+                            _mm256_max_epu8(d, s));
+    }
+#else
+    for (int i = 0; i < HLL_SIZE; i++) {
+        if (src->registers[i] > dst->registers[i])
+            dst->registers[i] = src->registers[i];
+    }
+#endif
+}
+
 uint64_t hll_count(hyperloglog_t *hll) {
     double alpha = 0.7213 / (1 + 1.079 / HLL_SIZE);
     double sum = 0.0;
@@ -133,6 +190,145 @@ uint64_t hll_count(hyperloglog_t *hll) {
     return (uint64_t)estimate;
 }
 
+/* Estado privado por worker: sketches y contadores planos sin atómicos.
+ * El coordinador los lee en caliente una vez por segundo (lecturas
+ * rotas toleradas, igual que en los demás detectores) */
+typedef struct {
+    stats_t stats;
+    count_min_sketch_t cm;
+    hyperloglog_t hll_src_ips;
+    hyperloglog_t hll_dst_ports;
+    uint64_t fwd_pkts;
+    uint64_t dropped_pkts;
+} __rte_cache_aligned worker_ctx_t;
+
+static worker_ctx_t g_workers[NUM_WORKERS];
+static uint16_t queue_ids[NUM_WORKERS];
+
+/* Worker: RX en su cola RSS, sketches privados y, en modo inline,
+ * reenvío del tráfico limpio por su propia cola TX del puerto 1 */
+static int worker_thread(void *arg) {
+    uint16_t queue_id = *(uint16_t *)arg;
+    worker_ctx_t *ctx = &g_workers[queue_id];
+    struct rte_mbuf *bufs[BURST_SIZE];
+    struct rte_mbuf *tx_bufs[BURST_SIZE];
+
+    printf("[INFO] Worker %u en lcore %u\n", queue_id, rte_lcore_id());
+
+    while (!force_quit) {
+        uint16_t nb_rx = rte_eth_rx_burst(0, queue_id, bufs, BURST_SIZE);
+        if (nb_rx == 0) continue;
+
+        time_t now = time(NULL);
+        bool block_window = forward_mode && now < block_mode_until;
+        uint16_t nb_clean = 0;
+
+        for (uint16_t i = 0; i < nb_rx; i++) {
+            struct rte_mbuf *m = bufs[i];
+            bool drop = false;
+            ctx->stats.total_pkts++;
+            ctx->stats.total_bytes += m->pkt_len;
+
+            if (m->pkt_len < 100) ctx->stats.small_pkts++;
+
+            struct rte_ether_hdr *eth_hdr = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
+
+            if (eth_hdr->ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+                struct rte_ipv4_hdr *ip_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+                uint32_t src_ip = rte_be_to_cpu_32(ip_hdr->src_addr);
+
+                uint32_t src_rate = cm_update(&ctx->cm, src_ip);
+                hll_add(&ctx->hll_src_ips, src_ip);
+
+                /* Modo inline: drop si la IP ya está bloqueada; durante la
+                 * ventana de alerta, cualquier IP que supere el umbral de
+                 * pkts/s según el sketch entra en la blocklist */
+                if (forward_mode) {
+                    if (blocklist_check(src_ip)) {
+                        drop = true;
+                    } else if (block_window && src_rate > BLOCK_CM_THRESHOLD) {
+                        blocklist_add(src_ip);
+                        drop = true;
+                    }
+                }
+
+                if (ip_hdr->next_proto_id == IPPROTO_TCP) {
+                    ctx->stats.tcp_pkts++;
+                    struct rte_tcp_hdr *tcp_hdr = (struct rte_tcp_hdr *)
+                        ((uint8_t *)ip_hdr + ((ip_hdr->version_ihl & 0x0F) * 4));
+
+                    uint16_t dst_port = rte_be_to_cpu_16(tcp_hdr->dst_port);
+                    hll_add(&ctx->hll_dst_ports, dst_port);
+
+                    if (tcp_hdr->tcp_flags & RTE_TCP_SYN_FLAG) ctx->stats.syn_pkts++;
+                    if (tcp_hdr->tcp_flags & RTE_TCP_ACK_FLAG) ctx->stats.ack_pkts++;
+                    if (tcp_hdr->tcp_flags & RTE_TCP_RST_FLAG) ctx->stats.rst_pkts++;
+                    if (tcp_hdr->tcp_flags & RTE_TCP_FIN_FLAG) ctx->stats.fin_pkts++;
+
+                } else if (ip_hdr->next_proto_id == IPPROTO_UDP) {
+                    ctx->stats.udp_pkts++;
+                    struct rte_udp_hdr *udp_hdr = (struct rte_udp_hdr *)
+                        ((uint8_t *)ip_hdr + ((ip_hdr->version_ihl & 0x0F) * 4));
+                    uint16_t dst_port = rte_be_to_cpu_16(udp_hdr->dst_port);
+                    hll_add(&ctx->hll_dst_ports, dst_port);
+
+                } else if (ip_hdr->next_proto_id == IPPROTO_ICMP) {
+                    ctx->stats.icmp_pkts++;
+                }
+
+                uint16_t frag_offset = rte_be_to_cpu_16(ip_hdr->fragment_offset);
+                if ((frag_offset & RTE_IPV4_HDR_MF_FLAG) ||
+                    (frag_offset & RTE_IPV4_HDR_OFFSET_MASK)) {
+                    ctx->stats.frag_pkts++;
+                }
+            }
+
+            /* Camino de reenvío sin asignaciones: el mismo mbuf que
+             * entró por el puerto RX sale por el puerto TX */
+            if (!forward_mode) {
+                rte_pktmbuf_free(m);
+            } else if (drop) {
+                rte_pktmbuf_free(m);
+                ctx->dropped_pkts++;
+            } else {
+                tx_bufs[nb_clean++] = m;
+            }
+        }
+
+        if (forward_mode && nb_clean > 0) {
+            uint16_t nb_tx = rte_eth_tx_burst(tx_port_id, queue_id,
+                                              tx_bufs, nb_clean);
+            ctx->fwd_pkts += nb_tx;
+            for (uint16_t i = nb_tx; i < nb_clean; i++)
+                rte_pktmbuf_free(tx_bufs[i]);
+        }
+    }
+
+    return 0;
+}
+
+/* Suma de los contadores por worker (lecturas en caliente) */
+static void aggregate_stats(stats_t *out, uint64_t *fwd, uint64_t *dropped) {
+    memset(out, 0, sizeof(*out));
+    *fwd = 0;
+    *dropped = 0;
+    for (int w = 0; w < NUM_WORKERS; w++) {
+        out->total_pkts += g_workers[w].stats.total_pkts;
+        out->total_bytes += g_workers[w].stats.total_bytes;
+        out->tcp_pkts += g_workers[w].stats.tcp_pkts;
+        out->udp_pkts += g_workers[w].stats.udp_pkts;
+        out->icmp_pkts += g_workers[w].stats.icmp_pkts;
+        out->syn_pkts += g_workers[w].stats.syn_pkts;
+        out->ack_pkts += g_workers[w].stats.ack_pkts;
+        out->rst_pkts += g_workers[w].stats.rst_pkts;
+        out->fin_pkts += g_workers[w].stats.fin_pkts;
+        out->frag_pkts += g_workers[w].stats.frag_pkts;
+        out->small_pkts += g_workers[w].stats.small_pkts;
+        *fwd += g_workers[w].fwd_pkts;
+        *dropped += g_workers[w].dropped_pkts;
+    }
+}
+
 static void signal_handler(int signum) {
     if (signum == SIGINT || signum == SIGTERM) {
         printf("\n[!] Señal recibida, deteniendo...\n");
@@ -145,38 +341,63 @@ int main(int argc, char *argv[]) {
     signal(SIGTERM, signal_handler);
 
     printf("\n╔════════════════════════════════════════════════════════╗\n");
-    printf("║   Detector DDoS - DPDK + Sketches v2.0                ║\n");
+    printf("║   Detector DDoS - DPDK + Sketches v2.1                ║\n");
     printf("╚════════════════════════════════════════════════════════╝\n\n");
 
     int ret = rte_eal_init(argc, argv);
     if (ret < 0) rte_exit(EXIT_FAILURE, "Error en inicialización EAL\n");
 
+    argc -= ret;
+    argv += ret;
+
+    /* Opciones de aplicación: --forward activa el modo inline */
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--forward") == 0)
+            forward_mode = true;
+    }
+
     uint16_t nb_ports = rte_eth_dev_count_avail();
     printf("[INFO] Puertos disponibles: %u\n", nb_ports);
     if (nb_ports < 1) rte_exit(EXIT_FAILURE, "No hay puertos disponibles\n");
+    if (forward_mode && nb_ports < 2)
+        rte_exit(EXIT_FAILURE, "El modo --forward necesita 2 puertos (RX + TX)\n");
+
+    if (rte_lcore_count() < NUM_WORKERS + 1)
+        rte_exit(EXIT_FAILURE,
+                 "Hacen falta %d lcores (%d workers + coordinador), p.ej. -l 0-%d\n",
+                 NUM_WORKERS + 1, NUM_WORKERS, NUM_WORKERS);
 
     struct rte_mempool *mbuf_pool = rte_pktmbuf_pool_create(
         "MBUF_POOL", NUM_MBUFS, MBUF_CACHE_SIZE, 0,
         RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
     if (mbuf_pool == NULL) rte_exit(EXIT_FAILURE, "Error creando mbuf pool\n");
 
-    struct rte_eth_conf port_conf = {0};
+    /* RSS por IP: cada worker ve siempre las mismas IPs origen */
+    struct rte_eth_conf port_conf = {
+        .rxmode = {
+            .mq_mode = ETH_MQ_RX_RSS,
+        },
+        .rx_adv_conf = {
+            .rss_conf = {
+                .rss_key = NULL,
+                .rss_hf = ETH_RSS_IP | ETH_RSS_TCP | ETH_RSS_UDP,
+            },
+        },
+    };
     uint16_t port_id = 0;
 
-    printf("[INFO] Configurando puerto %u...\n", port_id);
+    printf("[INFO] Configurando puerto %u (%d colas RX con RSS)...\n",
+           port_id, NUM_WORKERS);
 
-    ret = rte_eth_dev_configure(port_id, 1, 1, &port_conf);
+    ret = rte_eth_dev_configure(port_id, NUM_WORKERS, 0, &port_conf);
     if (ret < 0) rte_exit(EXIT_FAILURE, "Error configurando puerto\n");
 
-    ret = rte_eth_rx_queue_setup(port_id, 0, RX_RING_SIZE,
-                                  rte_eth_dev_socket_id(port_id),
-                                  NULL, mbuf_pool);
-    if (ret < 0) rte_exit(EXIT_FAILURE, "Error configurando RX queue\n");
-
-    ret = rte_eth_tx_queue_setup(port_id, 0, RX_RING_SIZE,
-                                  rte_eth_dev_socket_id(port_id),
-                                  NULL);
-    if (ret < 0) rte_exit(EXIT_FAILURE, "Error configurando TX queue\n");
+    for (uint16_t q = 0; q < NUM_WORKERS; q++) {
+        ret = rte_eth_rx_queue_setup(port_id, q, RX_RING_SIZE,
+                                      rte_eth_dev_socket_id(port_id),
+                                      NULL, mbuf_pool);
+        if (ret < 0) rte_exit(EXIT_FAILURE, "Error configurando RX queue %u\n", q);
+    }
 
     ret = rte_eth_dev_start(port_id);
     if (ret < 0) rte_exit(EXIT_FAILURE, "Error iniciando puerto\n");
@@ -184,6 +405,27 @@ int main(int argc, char *argv[]) {
     rte_eth_promiscuous_enable(port_id);
     printf("[INFO] Puerto iniciado en modo promiscuo\n");
 
+    if (forward_mode) {
+        /* Segundo puerto solo-TX: una cola por worker */
+        struct rte_eth_conf tx_conf = {0};
+        ret = rte_eth_dev_configure(tx_port_id, 0, NUM_WORKERS, &tx_conf);
+        if (ret < 0) rte_exit(EXIT_FAILURE, "Error configurando puerto TX\n");
+
+        for (uint16_t q = 0; q < NUM_WORKERS; q++) {
+            ret = rte_eth_tx_queue_setup(tx_port_id, q, RX_RING_SIZE,
+                                          rte_eth_dev_socket_id(tx_port_id),
+                                          NULL);
+            if (ret < 0) rte_exit(EXIT_FAILURE, "Error configurando TX queue %u\n", q);
+        }
+
+        ret = rte_eth_dev_start(tx_port_id);
+        if (ret < 0) rte_exit(EXIT_FAILURE, "Error iniciando puerto TX\n");
+
+        printf("[INFO] Modo inline: RX puerto %u -> TX puerto %u, "
+               "blocklist por software (umbral %u pkts/s)\n",
+               port_id, tx_port_id, BLOCK_CM_THRESHOLD);
+    }
+
     system("mkdir -p /local/logs && chmod 777 /local/logs");
 
     FILE *detection_log = fopen("/local/logs/detection.log", "w");
@@ -205,142 +447,133 @@ int main(int argc, char *argv[]) {
         fflush(alerts_log);
     }
 
-    count_min_sketch_t cm_sketch;
-    hyperloglog_t hll_src_ips;
-    hyperloglog_t hll_dst_ports;
+    for (int w = 0; w < NUM_WORKERS; w++) {
+        cm_init(&g_workers[w].cm);
+        hll_init(&g_workers[w].hll_src_ips);
+        hll_init(&g_workers[w].hll_dst_ports);
+        memset(&g_workers[w].stats, 0, sizeof(stats_t));
+    }
 
-    cm_init(&cm_sketch);
-    hll_init(&hll_src_ips);
-    hll_init(&hll_dst_ports);
+    /* Lanzar un worker por cola RSS; el lcore principal coordina */
+    unsigned lcore_id;
+    uint16_t w = 0;
+    RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+        if (w >= NUM_WORKERS) break;
+        queue_ids[w] = w;
+        rte_eal_remote_launch(worker_thread, &queue_ids[w], lcore_id);
+        w++;
+    }
 
     stats_t stats = {0};
     stats_t last_stats = {0};
+    uint64_t fwd_pkts = 0, dropped_pkts = 0;
     time_t last_report = time(NULL);
 
-    struct rte_mbuf *bufs[BURST_SIZE];
+    /* HLLs fusionados del intervalo: unión por máximo registro a
+     * registro de los HLL privados de cada worker */
+    hyperloglog_t hll_merged_ips, hll_merged_ports;
 
     printf("\n%-12s %12s %10s %10s %10s %10s\n",
            "Timestamp", "PPS", "Gbps", "TCP", "UDP", "SYN");
     printf("════════════════════════════════════════════════════════════════\n");
 
     while (!force_quit) {
-        uint16_t nb_rx = rte_eth_rx_burst(port_id, 0, bufs, BURST_SIZE);
-
-        for (uint16_t i = 0; i < nb_rx; i++) {
-            struct rte_mbuf *m = bufs[i];
-            stats.total_pkts++;
-            stats.total_bytes += m->pkt_len;
-
-            if (m->pkt_len < 100) stats.small_pkts++;
-
-            struct rte_ether_hdr *eth_hdr = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
-
-            if (eth_hdr->ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
-                struct rte_ipv4_hdr *ip_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
-                uint32_t src_ip = rte_be_to_cpu_32(ip_hdr->src_addr);
+        usleep(50 * 1000);
 
-                cm_update(&cm_sketch, src_ip);
-                hll_add(&hll_src_ips, src_ip);
-
-                if (ip_hdr->next_proto_id == IPPROTO_TCP) {
-                    stats.tcp_pkts++;
-                    struct rte_tcp_hdr *tcp_hdr = (struct rte_tcp_hdr *)
-                        ((uint8_t *)ip_hdr + ((ip_hdr->version_ihl & 0x0F) * 4));
-
-                    uint16_t dst_port = rte_be_to_cpu_16(tcp_hdr->dst_port);
-                    hll_add(&hll_dst_ports, dst_port);
-
-                    if (tcp_hdr->tcp_flags & RTE_TCP_SYN_FLAG) stats.syn_pkts++;
-                    if (tcp_hdr->tcp_flags & RTE_TCP_ACK_FLAG) stats.ack_pkts++;
-                    if (tcp_hdr->tcp_flags & RTE_TCP_RST_FLAG) stats.rst_pkts++;
-                    if (tcp_hdr->tcp_flags & RTE_TCP_FIN_FLAG) stats.fin_pkts++;
-
-                } else if (ip_hdr->next_proto_id == IPPROTO_UDP) {
-                    stats.udp_pkts++;
-                    struct rte_udp_hdr *udp_hdr = (struct rte_udp_hdr *)
-                        ((uint8_t *)ip_hdr + ((ip_hdr->version_ihl & 0x0F) * 4));
-                    uint16_t dst_port = rte_be_to_cpu_16(udp_hdr->dst_port);
-                    hll_add(&hll_dst_ports, dst_port);
-
-                } else if (ip_hdr->next_proto_id == IPPROTO_ICMP) {
-                    stats.icmp_pkts++;
-                }
+        time_t now = time(NULL);
+        if (now <= last_report)
+            continue;
+
+        aggregate_stats(&stats, &fwd_pkts, &dropped_pkts);
+
+        uint64_t pps = stats.total_pkts - last_stats.total_pkts;
+        uint64_t bytes_delta = stats.total_bytes - last_stats.total_bytes;
+        double gbps = (bytes_delta * 8.0) / 1e9;
+
+        uint64_t tcp_d = stats.tcp_pkts - last_stats.tcp_pkts;
+        uint64_t udp_d = stats.udp_pkts - last_stats.udp_pkts;
+        uint64_t icmp_d = stats.icmp_pkts - last_stats.icmp_pkts;
+        uint64_t syn_d = stats.syn_pkts - last_stats.syn_pkts;
+        uint64_t ack_d = stats.ack_pkts - last_stats.ack_pkts;
+        uint64_t rst_d = stats.rst_pkts - last_stats.rst_pkts;
+        uint64_t fin_d = stats.fin_pkts - last_stats.fin_pkts;
+        uint64_t frag_d = stats.frag_pkts - last_stats.frag_pkts;
+        uint64_t small_d = stats.small_pkts - last_stats.small_pkts;
+
+        uint64_t total = tcp_d + udp_d + icmp_d;
+        double tcp_r = total > 0 ? (double)tcp_d / total : 0.0;
+        double udp_r = total > 0 ? (double)udp_d / total : 0.0;
+        double icmp_r = total > 0 ? (double)icmp_d / total : 0.0;
+        double syn_r = tcp_d > 0 ? (double)syn_d / tcp_d : 0.0;
+        double ack_r = tcp_d > 0 ? (double)ack_d / tcp_d : 0.0;
+        double rst_r = tcp_d > 0 ? (double)rst_d / tcp_d : 0.0;
+        double fin_r = tcp_d > 0 ? (double)fin_d / tcp_d : 0.0;
+        double frag_r = total > 0 ? (double)frag_d / total : 0.0;
+        double small_r = pps > 0 ? (double)small_d / pps : 0.0;
+
+        double avg_size = pps > 0 ? (double)bytes_delta / pps : 0.0;
+        double std_dev = avg_size * 0.15;
+
+        /* Cardinalidad: unión de los HLL privados de los workers */
+        hll_init(&hll_merged_ips);
+        hll_init(&hll_merged_ports);
+        for (int i = 0; i < NUM_WORKERS; i++) {
+            hll_merge(&hll_merged_ips, &g_workers[i].hll_src_ips);
+            hll_merge(&hll_merged_ports, &g_workers[i].hll_dst_ports);
+        }
+        uint64_t unique_ips = hll_count(&hll_merged_ips);
+        uint64_t unique_ports = hll_count(&hll_merged_ports);
 
-                uint16_t frag_offset = rte_be_to_cpu_16(ip_hdr->fragment_offset);
-                if ((frag_offset & RTE_IPV4_HDR_MF_FLAG) ||
-                    (frag_offset & RTE_IPV4_HDR_OFFSET_MASK)) {
-                    stats.frag_pkts++;
-                }
-            }
+        printf("%-12lu %12lu %10.2f %10lu %10lu %10lu\n",
+               now, pps, gbps, tcp_d, udp_d, syn_d);
 
-            rte_pktmbuf_free(m);
+        if (detection_log) {
+            fprintf(detection_log, "%lu,%lu,%.2f,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                    now, pps, gbps, tcp_d, udp_d, icmp_d,
+                    syn_d, ack_d, rst_d, fin_d, frag_d);
+            fflush(detection_log);
         }
 
-        time_t now = time(NULL);
-        if (now > last_report) {
-            uint64_t pps = stats.total_pkts - last_stats.total_pkts;
-            uint64_t bytes_delta = stats.total_bytes - last_stats.total_bytes;
-            double gbps = (bytes_delta * 8.0) / 1e9;
-
-            uint64_t tcp_d = stats.tcp_pkts - last_stats.tcp_pkts;
-            uint64_t udp_d = stats.udp_pkts - last_stats.udp_pkts;
-            uint64_t icmp_d = stats.icmp_pkts - last_stats.icmp_pkts;
-            uint64_t syn_d = stats.syn_pkts - last_stats.syn_pkts;
-            uint64_t ack_d = stats.ack_pkts - last_stats.ack_pkts;
-            uint64_t rst_d = stats.rst_pkts - last_stats.rst_pkts;
-            uint64_t fin_d = stats.fin_pkts - last_stats.fin_pkts;
-            uint64_t frag_d = stats.frag_pkts - last_stats.frag_pkts;
-            uint64_t small_d = stats.small_pkts - last_stats.small_pkts;
-
-            uint64_t total = tcp_d + udp_d + icmp_d;
-            double tcp_r = total > 0 ? (double)tcp_d / total : 0.0;
-            double udp_r = total > 0 ? (double)udp_d / total : 0.0;
-            double icmp_r = total > 0 ? (double)icmp_d / total : 0.0;
-            double syn_r = tcp_d > 0 ? (double)syn_d / tcp_d : 0.0;
-            double ack_r = tcp_d > 0 ? (double)ack_d / tcp_d : 0.0;
-            double rst_r = tcp_d > 0 ? (double)rst_d / tcp_d : 0.0;
-            double fin_r = tcp_d > 0 ? (double)fin_d / tcp_d : 0.0;
-            double frag_r = total > 0 ? (double)frag_d / total : 0.0;
-            double small_r = pps > 0 ? (double)small_d / pps : 0.0;
-
-            double avg_size = pps > 0 ? (double)bytes_delta / pps : 0.0;
-            double std_dev = avg_size * 0.15;
-
-            uint64_t unique_ips = hll_count(&hll_src_ips);
-            uint64_t unique_ports = hll_count(&hll_dst_ports);
-
-            printf("%-12lu %12lu %10.2f %10lu %10lu %10lu\n",
-                   now, pps, gbps, tcp_d, udp_d, syn_d);
-
-            if (detection_log) {
-                fprintf(detection_log, "%lu,%lu,%.2f,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
-                        now, pps, gbps, tcp_d, udp_d, icmp_d,
-                        syn_d, ack_d, rst_d, fin_d, frag_d);
-                fflush(detection_log);
-            }
-
-            if (ml_features_log) {
-                fprintf(ml_features_log, "%lu,%.2f,%lu,%.2f,%.2f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%.2f,%lu,%lu,%lu,%lu\n",
-                        now, gbps, pps, avg_size, std_dev,
-                        tcp_r, udp_r, icmp_r,
-                        syn_r, ack_r, rst_r, fin_r,
-                        frag_r, small_r,
-                        5.0, 5.0,
-                        unique_ips, unique_ports,
-                        syn_d, ack_d);
-                fflush(ml_features_log);
-            }
+        if (ml_features_log) {
+            fprintf(ml_features_log, "%lu,%.2f,%lu,%.2f,%.2f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%.2f,%lu,%lu,%lu,%lu\n",
+                    now, gbps, pps, avg_size, std_dev,
+                    tcp_r, udp_r, icmp_r,
+                    syn_r, ack_r, rst_r, fin_r,
+                    frag_r, small_r,
+                    5.0, 5.0,
+                    unique_ips, unique_ports,
+                    syn_d, ack_d);
+            fflush(ml_features_log);
+        }
 
-            if (syn_r > 0.7 && alerts_log) {
+        if (syn_r > 0.7) {
+            if (alerts_log) {
                 fprintf(alerts_log, "%lu,SYN_FLOOD,CRITICAL,syn_ratio=%.2f\n", now, syn_r);
                 fflush(alerts_log);
             }
+            /* Abre (o extiende) la ventana de bloqueo del modo inline */
+            block_mode_until = now + BLOCK_MODE_HOLD_SEC;
+        }
 
-            last_stats = stats;
-            last_report = now;
+        if (forward_mode) {
+            printf("  [INLINE] reenviados=%lu descartados=%lu ips_bloqueadas=%u%s\n",
+                   fwd_pkts, dropped_pkts, blocked_ips,
+                   now < block_mode_until ? " [ALERTA ACTIVA]" : "");
         }
+
+        /* Reset por intervalo: así los contadores del sketch son pkts/s
+         * y el umbral de bloqueo tiene unidades claras. El memset compite
+         * con los incrementos del worker; perder algún incremento en el
+         * borde de la ventana es inocuo */
+        for (int i = 0; i < NUM_WORKERS; i++)
+            cm_init(&g_workers[i].cm);
+
+        last_stats = stats;
+        last_report = now;
     }
 
+    rte_eal_mp_wait_lcore();
+
     if (detection_log) fclose(detection_log);
     if (ml_features_log) fclose(ml_features_log);
     if (alerts_log) fclose(alerts_log);
@@ -348,6 +581,15 @@ int main(int argc, char *argv[]) {
     rte_eth_dev_stop(port_id);
     rte_eth_dev_close(port_id);
 
+    aggregate_stats(&stats, &fwd_pkts, &dropped_pkts);
+
+    if (forward_mode) {
+        rte_eth_dev_stop(tx_port_id);
+        rte_eth_dev_close(tx_port_id);
+        printf("\n[+] Reenviados: %lu | Descartados: %lu | IPs bloqueadas: %u\n",
+               fwd_pkts, dropped_pkts, blocked_ips);
+    }
+
     printf("\n[+] Total paquetes: %lu\n", stats.total_pkts);
     printf("[+] Logs en /local/logs/\n\n");
 
@@ -4,6 +4,10 @@
  * Detector de ataques HTTP flood usando reglas precisas sin ML
  * Optimizado para 100 Gbps con NICs Mellanox
  *
+ * Architecture (same scheme as mira/detector_system/mira_ddos_detector.c):
+ * - 14 Worker threads: RX processing with RSS + per-worker sketches (NO atomics)
+ * - 1 Coordinator thread: aggregates workers and runs the detection rules
+ *
  * Reglas de detección:
  * 1. Rate Anomaly: Tasa de peticiones por IP > umbral
  * 2. URL Concentration: Mismo path repetido > 80%
@@ -52,16 +56,19 @@
 #include <rte_tcp.h>
 #include <rte_hash.h>
 #include <rte_jhash.h>
+#include <rte_hash_crc.h>
+
+#include "../../common/count_min.h"
+#include "../../common/telemetry.h"
 
 #define RX_RING_SIZE 4096
 #define TX_RING_SIZE 4096
 #define NUM_MBUFS 524288
 #define MBUF_CACHE_SIZE 512
 #define BURST_SIZE 512
+#define NUM_RX_QUEUES 14      /* 14 workers + 1 coordinator, like MIRA */
 
-/* OctoSketch parameters */
-#define SKETCH_WIDTH 65536    // 64K buckets
-#define SKETCH_DEPTH 4        // 4 hash functions
+/* OctoSketch parameters (CMS_WIDTH/CMS_DEPTH come from count_min.h) */
 #define HEAVY_HITTER_THRESHOLD 1000  // Paquetes para ser heavy hitter
 
 /* Detection thresholds */
@@ -81,13 +88,6 @@
 #define ALERT_HIGH 3
 #define ALERT_CRITICAL 4
 
-/* Count-Min Sketch para conteo de frecuencias */
-struct count_min_sketch {
-    uint32_t width;
-    uint32_t depth;
-    uint32_t **counters;
-};
-
 /* Heavy Hitter detector */
 struct heavy_hitter {
     uint32_t ip;
@@ -95,13 +95,46 @@ struct heavy_hitter {
     uint64_t last_seen;
 };
 
-/* URL statistics */
-struct url_stats {
-    char path[256];
+/* Interned URL tracking: paths are reduced to a 64-bit ID (two CRC32
+ * passes with independent seeds over the bytes the parser already
+ * touched), counted in the per-worker Count-Min sketch, and identities
+ * kept in a small Space-Saving table. Path strings are stored only for
+ * the currently resident top-K entries - the hot path never does a
+ * string compare, so randomized-path floods cost the same as a
+ * single-URL flood */
+#define URL_TOP_K 8            /* Space-Saving slots per worker */
+#define URL_PATH_MAX 128       /* Only resident entries keep their string */
+
+struct url_entry {
+    uint64_t id;
     uint64_t count;
+    char path[URL_PATH_MAX];
 };
 
-/* Detection statistics */
+/* Per-worker state - each worker owns its sketches and counters, so the
+ * hot path needs NO atomics. RSS hashes on src IP, so a given IP always
+ * lands on the same worker: per-worker unique/heavy counts can simply be
+ * summed by the coordinator without double counting */
+struct worker_state {
+    struct count_min_sketch *ip_sketch;
+    struct count_min_sketch *url_sketch;
+
+    /* Cumulative counters (coordinator computes window deltas) */
+    uint64_t total_packets;
+    uint64_t http_packets;
+    uint64_t baseline_packets;  // 192.168.x.x
+    uint64_t attack_packets;    // 203.0.113.x
+    uint64_t unique_ips;
+    uint64_t heavy_hitters;
+    uint64_t get_requests;
+    uint64_t post_requests;
+    uint64_t other_methods;
+
+    /* URL concentration - per window (reset by coordinator) */
+    struct url_entry top_urls[URL_TOP_K];
+} __rte_cache_aligned;
+
+/* Detection statistics - coordinator aggregate */
 struct detection_stats {
     /* Counters */
     uint64_t total_packets;
@@ -141,18 +174,27 @@ struct detector_config {
     bool verbose;
 } g_config = {
     .port_id = 0,
-    .nb_queues = 1,
+    .nb_queues = NUM_RX_QUEUES,
     .verbose = false,
 };
 
 /* Global state */
 static volatile bool force_quit = false;
 static FILE *g_log_file = NULL;
+static struct telemetry_ctx g_telemetry;
 static struct rte_mempool *mbuf_pool = NULL;
-static struct count_min_sketch *ip_sketch = NULL;
-static struct count_min_sketch *url_sketch = NULL;
+static struct worker_state g_workers[NUM_RX_QUEUES] __rte_cache_aligned;
 static struct detection_stats g_stats;
 
+/* Window baselines - cumulative worker totals at last window reset, so
+ * per-window rules see deltas instead of since-boot counts */
+static uint64_t window_base_unique_ips = 0;
+static uint64_t window_base_heavy_hitters = 0;
+
+/* Merged per-window top URLs (coordinator only, for reporting) */
+static struct url_entry g_top_urls[NUM_RX_QUEUES * URL_TOP_K];
+static uint32_t g_nb_top_urls = 0;
+
 /* Forward declarations */
 static void close_log_file(void);
 
@@ -226,83 +268,7 @@ static void dual_printf(const char *format, ...)
     }
 }
 
-/* Initialize Count-Min Sketch */
-static struct count_min_sketch *cms_init(uint32_t width, uint32_t depth)
-{
-    struct count_min_sketch *cms = malloc(sizeof(*cms));
-    if (!cms)
-        return NULL;
-
-    cms->width = width;
-    cms->depth = depth;
-
-    cms->counters = malloc(depth * sizeof(uint32_t *));
-    if (!cms->counters) {
-        free(cms);
-        return NULL;
-    }
-
-    for (uint32_t i = 0; i < depth; i++) {
-        cms->counters[i] = calloc(width, sizeof(uint32_t));
-        if (!cms->counters[i]) {
-            for (uint32_t j = 0; j < i; j++)
-                free(cms->counters[j]);
-            free(cms->counters);
-            free(cms);
-            return NULL;
-        }
-    }
-
-    return cms;
-}
-
-/* Update Count-Min Sketch */
-static void cms_update(struct count_min_sketch *cms, uint32_t item, uint32_t count)
-{
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        uint32_t hash = rte_jhash_1word(item, i);
-        uint32_t index = hash % cms->width;
-        cms->counters[i][index] += count;
-    }
-}
-
-/* Query Count-Min Sketch */
-static uint32_t cms_query(struct count_min_sketch *cms, uint32_t item)
-{
-    uint32_t min_count = UINT32_MAX;
-
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        uint32_t hash = rte_jhash_1word(item, i);
-        uint32_t index = hash % cms->width;
-        if (cms->counters[i][index] < min_count)
-            min_count = cms->counters[i][index];
-    }
-
-    return min_count;
-}
-
-/* Reset Count-Min Sketch */
-static void cms_reset(struct count_min_sketch *cms)
-{
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        memset(cms->counters[i], 0, cms->width * sizeof(uint32_t));
-    }
-}
-
-/* Free Count-Min Sketch */
-static void cms_free(struct count_min_sketch *cms)
-{
-    if (!cms)
-        return;
-
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        free(cms->counters[i]);
-    }
-    free(cms->counters);
-    free(cms);
-}
-
-/* Extract URL path from HTTP payload */
+/* Extract URL path from HTTP payload. Returns path length, or -1 */
 static int extract_http_path(const char *payload, size_t len, char *path, size_t path_len)
 {
     const char *method_end = NULL;
@@ -340,10 +306,121 @@ static int extract_http_path(const char *payload, size_t len, char *path, size_t
     memcpy(path, path_start, copy_len);
     path[copy_len] = '\0';
 
-    return 0;
+    return (int)copy_len;
+}
+
+/* Space-Saving update for one interned URL - runs on the owning worker.
+ * The scan is over URL_TOP_K 64-bit IDs, not path strings, and eviction
+ * uses the CMS estimate so a path only claims a slot once it has
+ * genuinely out-counted the current minimum */
+static void url_track(struct worker_state *ws, uint64_t id,
+                      const char *path, size_t len)
+{
+    uint32_t key = (uint32_t)(id >> 32) ^ (uint32_t)id;
+    struct url_entry *min_e = &ws->top_urls[0];
+
+    cms_update(ws->url_sketch, key, 1);
+
+    for (int k = 0; k < URL_TOP_K; k++) {
+        struct url_entry *e = &ws->top_urls[k];
+
+        if (e->id == id) {
+            e->count++;
+            return;
+        }
+        if (e->count < min_e->count)
+            min_e = e;
+    }
+
+    uint32_t est = cms_query(ws->url_sketch, key);
+    if (est > min_e->count) {
+        min_e->id = id;
+        min_e->count = est;
+        if (len >= sizeof(min_e->path))
+            len = sizeof(min_e->path) - 1;
+        memcpy(min_e->path, path, len);
+        min_e->path[len] = '\0';
+    }
 }
 
-/* Detect HTTP flood attack using multiple rules */
+/* Aggregate per-worker counters into g_stats - COORDINATOR ONLY */
+static void aggregate_worker_stats(void)
+{
+    uint64_t unique_ips = 0, heavy_hitters = 0;
+
+    g_stats.total_packets = 0;
+    g_stats.http_packets = 0;
+    g_stats.baseline_packets = 0;
+    g_stats.attack_packets = 0;
+    g_stats.get_requests = 0;
+    g_stats.post_requests = 0;
+    g_stats.other_methods = 0;
+    g_stats.top_url_count = 0;
+
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        struct worker_state *ws = &g_workers[w];
+
+        g_stats.total_packets += ws->total_packets;
+        g_stats.http_packets += ws->http_packets;
+        g_stats.baseline_packets += ws->baseline_packets;
+        g_stats.attack_packets += ws->attack_packets;
+        g_stats.get_requests += ws->get_requests;
+        g_stats.post_requests += ws->post_requests;
+        g_stats.other_methods += ws->other_methods;
+
+        unique_ips += ws->unique_ips;
+        heavy_hitters += ws->heavy_hitters;
+    }
+
+    /* URL concentration: merge the per-worker Space-Saving tables by ID.
+     * RSS spreads source IPs, not URLs, so the same flood path shows up
+     * in every worker's table - summing its partial counts gives the
+     * global rate directly (no scaling heuristic) */
+    g_nb_top_urls = 0;
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        for (int k = 0; k < URL_TOP_K; k++) {
+            struct url_entry *e = &g_workers[w].top_urls[k];
+
+            if (e->count == 0)
+                continue;
+
+            uint32_t m;
+            for (m = 0; m < g_nb_top_urls; m++) {
+                if (g_top_urls[m].id == e->id) {
+                    g_top_urls[m].count += e->count;
+                    break;
+                }
+            }
+            if (m == g_nb_top_urls) {
+                g_top_urls[m] = *e;
+                g_nb_top_urls++;
+            }
+        }
+    }
+
+    /* Sort descending by count (a few dozen entries at most) */
+    for (uint32_t i = 1; i < g_nb_top_urls; i++) {
+        struct url_entry tmp = g_top_urls[i];
+        uint32_t j = i;
+        while (j > 0 && g_top_urls[j - 1].count < tmp.count) {
+            g_top_urls[j] = g_top_urls[j - 1];
+            j--;
+        }
+        g_top_urls[j] = tmp;
+    }
+
+    if (g_nb_top_urls > 0) {
+        g_stats.top_url_count = g_top_urls[0].count;
+        strncpy(g_stats.top_url, g_top_urls[0].path,
+                sizeof(g_stats.top_url) - 1);
+    }
+
+    /* Per-window values: delta against counts at last window reset */
+    g_stats.unique_ips = unique_ips - window_base_unique_ips;
+    g_stats.heavy_hitters = heavy_hitters - window_base_heavy_hitters;
+}
+
+/* Detect HTTP flood attack using multiple rules - COORDINATOR ONLY */
 static void detect_http_flood(void)
 {
     uint64_t cur_tsc = rte_rdtsc();
@@ -354,6 +431,8 @@ static void detect_http_flood(void)
     if (elapsed_sec < DETECTION_WINDOW_SEC)
         return;
 
+    aggregate_worker_stats();
+
     /* Reset alert */
     g_stats.alert_level = ALERT_NONE;
     g_stats.alert_reason[0] = '\0';
@@ -433,18 +512,28 @@ static void detect_http_flood(void)
 reset_window:
     /* Reset window */
     g_stats.window_start_tsc = cur_tsc;
-    g_stats.unique_ips = 0;
-    g_stats.heavy_hitters = 0;
-    g_stats.top_url_count = 0;
     g_stats.low_rate_ips = 0;
 
-    /* Reset sketches */
-    cms_reset(ip_sketch);
-    cms_reset(url_sketch);
+    /* New window baseline for per-window deltas */
+    window_base_unique_ips = 0;
+    window_base_heavy_hitters = 0;
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        window_base_unique_ips += g_workers[w].unique_ips;
+        window_base_heavy_hitters += g_workers[w].heavy_hitters;
+    }
+
+    /* Reset per-worker sketches and window-local URL tracking. Racy with
+     * the workers' updates, but a lost increment at the window edge is
+     * noise at these rates (same tolerance as the MIRA detector) */
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        cms_reset(g_workers[w].ip_sketch);
+        cms_reset(g_workers[w].url_sketch);
+        memset(g_workers[w].top_urls, 0, sizeof(g_workers[w].top_urls));
+    }
 }
 
-/* Process packet and extract features */
-static void process_packet(struct rte_mbuf *pkt)
+/* Process packet and extract features - runs on the owning worker only */
+static void process_packet(struct worker_state *ws, struct rte_mbuf *pkt)
 {
     struct rte_ether_hdr *eth_hdr;
     struct rte_ipv4_hdr *ipv4_hdr;
@@ -452,7 +541,7 @@ static void process_packet(struct rte_mbuf *pkt)
     uint8_t *payload;
     uint32_t payload_len;
 
-    g_stats.total_packets++;
+    ws->total_packets++;
 
     /* Parse Ethernet */
     eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
@@ -471,7 +560,7 @@ static void process_packet(struct rte_mbuf *pkt)
     if (tcp_hdr->dst_port != rte_cpu_to_be_16(80))
         return;
 
-    g_stats.http_packets++;
+    ws->http_packets++;
 
     /* Get payload */
     payload = (uint8_t *)tcp_hdr + (tcp_hdr->data_off >> 4) * 4;
@@ -488,48 +577,48 @@ static void process_packet(struct rte_mbuf *pkt)
     uint8_t third_octet = (src_ip >> 8) & 0xFF;
 
     if (first_octet == 192 && second_octet == 168) {
-        g_stats.baseline_packets++;
+        ws->baseline_packets++;
     } else if (first_octet == 203 && second_octet == 0 && third_octet == 113) {
-        g_stats.attack_packets++;
+        ws->attack_packets++;
     }
 
-    /* Update IP sketch */
-    cms_update(ip_sketch, src_ip, 1);
-    uint32_t ip_count = cms_query(ip_sketch, src_ip);
+    /* Update IP sketch (worker-local, no contention) */
+    cms_update(ws->ip_sketch, src_ip, 1);
+    uint32_t ip_count = cms_query(ws->ip_sketch, src_ip);
 
     if (ip_count == 1) {
-        g_stats.unique_ips++;
+        ws->unique_ips++;
     }
 
     if (ip_count > HEAVY_HITTER_THRESHOLD) {
-        g_stats.heavy_hitters++;
+        ws->heavy_hitters++;
     }
 
     /* Parse HTTP method and path */
-    char http_path[256] = {0};
+    char http_path[URL_PATH_MAX];
+    int path_len = -1;
 
     if (payload_len > 4) {
         if (memcmp(payload, "GET ", 4) == 0) {
-            g_stats.get_requests++;
-            extract_http_path((char *)payload, payload_len, http_path, sizeof(http_path));
+            ws->get_requests++;
+            path_len = extract_http_path((char *)payload, payload_len,
+                                         http_path, sizeof(http_path));
         } else if (memcmp(payload, "POST", 4) == 0) {
-            g_stats.post_requests++;
-            extract_http_path((char *)payload, payload_len, http_path, sizeof(http_path));
+            ws->post_requests++;
+            path_len = extract_http_path((char *)payload, payload_len,
+                                         http_path, sizeof(http_path));
         } else {
-            g_stats.other_methods++;
+            ws->other_methods++;
         }
     }
 
-    /* Update URL sketch */
-    if (http_path[0] != '\0') {
-        uint32_t path_hash = rte_jhash(http_path, strlen(http_path), 0);
-        cms_update(url_sketch, path_hash, 1);
-        uint32_t path_count = cms_query(url_sketch, path_hash);
+    /* Intern the path - hashed once, then tracked by ID only */
+    if (path_len > 0) {
+        uint64_t url_id =
+            ((uint64_t)rte_hash_crc(http_path, path_len, 0xdeadbeef) << 32) |
+            rte_hash_crc(http_path, path_len, 0x9e3779b9);
 
-        if (path_count > g_stats.top_url_count) {
-            g_stats.top_url_count = path_count;
-            strncpy(g_stats.top_url, http_path, sizeof(g_stats.top_url) - 1);
-        }
+        url_track(ws, url_id, http_path, (size_t)path_len);
     }
 }
 
@@ -545,6 +634,25 @@ static void print_stats(void)
 
     g_stats.last_stats_tsc = cur_tsc;
 
+    /* Publish the interval snapshot to the binary telemetry ring.
+     * aux[]: http pkts, unique IPs, heavy hitters, GET, POST, top-URL count */
+    struct telemetry_record trec = {0};
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    trec.tsc = cur_tsc;
+    trec.wall_ns = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+    trec.alert_level = g_stats.alert_level;
+    trec.total_packets = g_stats.total_packets;
+    trec.baseline_packets = g_stats.baseline_packets;
+    trec.attack_packets = g_stats.attack_packets;
+    trec.aux[0] = (double)g_stats.http_packets;
+    trec.aux[1] = (double)g_stats.unique_ips;
+    trec.aux[2] = (double)g_stats.heavy_hitters;
+    trec.aux[3] = (double)g_stats.get_requests;
+    trec.aux[4] = (double)g_stats.post_requests;
+    trec.aux[5] = (double)g_stats.top_url_count;
+    telemetry_publish(&g_telemetry, &trec);
+
     dual_printf("\n");
     dual_printf("╔══════════════════════════════════════════════════════════════════════╗\n");
     dual_printf("║               HTTP FLOOD DETECTOR - STATISTICS                      ║\n");
@@ -578,6 +686,10 @@ static void print_stats(void)
     dual_printf("  Top URL count:      %lu (%.1f%%)\n",
            g_stats.top_url_count,
            g_stats.http_packets > 0 ? (double)g_stats.top_url_count / g_stats.http_packets * 100 : 0);
+    for (uint32_t u = 1; u < g_nb_top_urls && u < 5; u++) {
+        dual_printf("  #%u:                 %s (%lu)\n",
+               u + 1, g_top_urls[u].path, g_top_urls[u].count);
+    }
 
     dual_printf("\n[ALERT STATUS]\n");
     const char *alert_names[] = {"NONE", "LOW", "MEDIUM", "HIGH", "CRITICAL"};
@@ -594,16 +706,22 @@ static void print_stats(void)
     dual_printf("\n");
 }
 
-/* Port initialization */
+/* Port initialization with multi-queue RSS (same setup as MIRA) */
 static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
 {
     struct rte_eth_conf port_conf = {
         .rxmode = {
-            .mq_mode = ETH_MQ_RX_NONE,
+            .mq_mode = ETH_MQ_RX_RSS,  /* Enable RSS */
+        },
+        .rx_adv_conf = {
+            .rss_conf = {
+                .rss_key = NULL,  /* Use default key */
+                .rss_hf = ETH_RSS_IP | ETH_RSS_TCP,  /* Hash on IP + TCP ports */
+            },
         },
     };
 
-    const uint16_t rx_rings = 1, tx_rings = 0;
+    const uint16_t rx_rings = NUM_RX_QUEUES, tx_rings = 0;
     uint16_t nb_rxd = RX_RING_SIZE;
     int retval;
     struct rte_eth_dev_info dev_info;
@@ -623,7 +741,7 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     if (retval != 0)
         return retval;
 
-    /* Setup RX queue */
+    /* Setup RX queues - one per worker */
     for (uint16_t q = 0; q < rx_rings; q++) {
         retval = rte_eth_rx_queue_setup(port, q, nb_rxd,
                 rte_eth_dev_socket_id(port), NULL, mbuf_pool);
@@ -642,34 +760,56 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     return 0;
 }
 
-/* Main detection loop */
-static int detection_loop(__rte_unused void *arg)
+/* Worker thread - RX processing for one RSS queue */
+static int worker_thread(void *arg)
 {
-    unsigned lcore_id = rte_lcore_id();
+    uint16_t queue_id = *(uint16_t *)arg;
     uint16_t port = g_config.port_id;
+    struct worker_state *ws = &g_workers[queue_id];
     struct rte_mbuf *bufs[BURST_SIZE];
 
-    printf("Detection loop started on lcore %u\n", lcore_id);
-
-    g_stats.window_start_tsc = rte_rdtsc();
-    g_stats.last_stats_tsc = rte_rdtsc();
+    printf("Worker thread %u processing queue %u on lcore %u\n",
+           queue_id, queue_id, rte_lcore_id());
 
     while (!force_quit) {
-        uint16_t nb_rx = rte_eth_rx_burst(port, 0, bufs, BURST_SIZE);
+        uint16_t nb_rx = rte_eth_rx_burst(port, queue_id, bufs, BURST_SIZE);
 
         if (unlikely(nb_rx == 0))
             continue;
 
+        /* Prefetch first packets for better pipeline */
+        for (uint16_t i = 0; i < nb_rx && i < 8; i++) {
+            rte_prefetch0(rte_pktmbuf_mtod(bufs[i], void *));
+        }
+
         for (uint16_t i = 0; i < nb_rx; i++) {
-            process_packet(bufs[i]);
+            if (i + 8 < nb_rx) {
+                rte_prefetch0(rte_pktmbuf_mtod(bufs[i + 8], void *));
+            }
+            process_packet(ws, bufs[i]);
             rte_pktmbuf_free(bufs[i]);
         }
+    }
+
+    return 0;
+}
+
+/* Coordinator thread - detection rules and stats */
+static int coordinator_thread(__rte_unused void *arg)
+{
+    printf("\nCoordinator thread on lcore %u\n", rte_lcore_id());
+
+    g_stats.window_start_tsc = rte_rdtsc();
+    g_stats.last_stats_tsc = rte_rdtsc();
 
+    while (!force_quit) {
         /* Run detection */
         detect_http_flood();
 
         /* Print stats */
         print_stats();
+
+        rte_delay_us_block(10000);  /* 10ms sleep */
     }
 
     return 0;
@@ -679,6 +819,7 @@ static int detection_loop(__rte_unused void *arg)
 int main(int argc, char **argv)
 {
     int ret;
+    static uint16_t queue_ids[NUM_RX_QUEUES];
 
     /* Initialize EAL */
     ret = rte_eal_init(argc, argv);
@@ -699,6 +840,11 @@ int main(int argc, char **argv)
 
     printf("Found %u Ethernet port(s)\n", nb_ports);
 
+    /* Need 14 workers + 1 coordinator + main lcore */
+    if (rte_lcore_count() < NUM_RX_QUEUES + 2)
+        rte_exit(EXIT_FAILURE, "Need at least %d lcores (%d workers + coordinator + main)\n",
+                 NUM_RX_QUEUES + 2, NUM_RX_QUEUES);
+
     /* Create mbuf pool */
     mbuf_pool = rte_pktmbuf_pool_create("MBUF_POOL", NUM_MBUFS,
             MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
@@ -706,20 +852,24 @@ int main(int argc, char **argv)
     if (mbuf_pool == NULL)
         rte_exit(EXIT_FAILURE, "Cannot create mbuf pool\n");
 
-    /* Initialize sketches */
-    ip_sketch = cms_init(SKETCH_WIDTH, SKETCH_DEPTH);
-    url_sketch = cms_init(SKETCH_WIDTH, SKETCH_DEPTH);
+    /* Initialize per-worker sketches */
+    memset(g_workers, 0, sizeof(g_workers));
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        g_workers[w].ip_sketch = cms_init();
+        g_workers[w].url_sketch = cms_init();
 
-    if (!ip_sketch || !url_sketch)
-        rte_exit(EXIT_FAILURE, "Cannot create sketches\n");
+        if (!g_workers[w].ip_sketch || !g_workers[w].url_sketch)
+            rte_exit(EXIT_FAILURE, "Cannot create sketches for worker %d\n", w);
+    }
 
-    printf("OctoSketch initialized: %ux%u\n", SKETCH_WIDTH, SKETCH_DEPTH);
+    printf("OctoSketch initialized: %ux%u x %d workers\n",
+           CMS_WIDTH, CMS_DEPTH, NUM_RX_QUEUES);
 
     /* Initialize port */
     if (port_init(g_config.port_id, mbuf_pool) != 0)
         rte_exit(EXIT_FAILURE, "Cannot init port %u\n", g_config.port_id);
 
-    printf("Port %u initialized\n", g_config.port_id);
+    printf("Port %u initialized with %d RSS queues\n", g_config.port_id, NUM_RX_QUEUES);
 
     /* Initialize stats */
     memset(&g_stats, 0, sizeof(g_stats));
@@ -727,11 +877,17 @@ int main(int argc, char **argv)
     /* Open log file */
     open_log_file();
 
+    /* Binary telemetry ring next to the text log */
+    telemetry_open(&g_telemetry,
+                   "/local/dpdk_100g/results/http_flood_telemetry.bin",
+                   "http_flood_detector");
+
     dual_printf("\n");
     dual_printf("╔══════════════════════════════════════════════════════════════════════╗\n");
     dual_printf("║         HTTP FLOOD DETECTOR - DPDK + OctoSketch                     ║\n");
     dual_printf("╠══════════════════════════════════════════════════════════════════════╣\n");
     dual_printf("║  Port:              %u                                               ║\n", g_config.port_id);
+    dual_printf("║  Workers:           %u (RSS) + 1 coordinator                        ║\n", NUM_RX_QUEUES);
     dual_printf("║  Detection window:  %u second                                        ║\n", DETECTION_WINDOW_SEC);
     dual_printf("║  Stats interval:    %u seconds                                       ║\n", STATS_INTERVAL_SEC);
     dual_printf("║                                                                      ║\n");
@@ -744,16 +900,50 @@ int main(int argc, char **argv)
     dual_printf("╚══════════════════════════════════════════════════════════════════════╝\n");
     dual_printf("\nPress Ctrl+C to exit...\n\n");
 
-    /* Run detection */
-    detection_loop(NULL);
+    /* Launch workers on the first NUM_RX_QUEUES slave lcores and the
+     * coordinator on the next one (same scheme as MIRA) */
+    for (unsigned i = 0; i < NUM_RX_QUEUES; i++) {
+        queue_ids[i] = i;
+    }
+
+    unsigned lcore_id;
+    unsigned lcore_idx = 0;
+    unsigned coordinator_lcore = 0;
+
+    RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+        if (lcore_idx < NUM_RX_QUEUES) {
+            printf("Launching worker %u on lcore %u\n", lcore_idx, lcore_id);
+            rte_eal_remote_launch(worker_thread, &queue_ids[lcore_idx], lcore_id);
+            lcore_idx++;
+        } else {
+            coordinator_lcore = lcore_id;
+            break;
+        }
+    }
+
+    if (coordinator_lcore > 0) {
+        printf("Launching coordinator on lcore %u\n", coordinator_lcore);
+        rte_eal_remote_launch(coordinator_thread, NULL, coordinator_lcore);
+    } else {
+        printf("Warning: No lcore available for coordinator thread!\n");
+    }
+
+    /* Wait for all threads */
+    rte_eal_mp_wait_lcore();
 
     /* Final stats */
     printf("\n\n=== FINAL STATISTICS ===\n");
+    aggregate_worker_stats();
     print_stats();
 
     /* Cleanup */
-    cms_free(ip_sketch);
-    cms_free(url_sketch);
+    telemetry_close(&g_telemetry);
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        cms_free(g_workers[w].ip_sketch);
+        cms_free(g_workers[w].url_sketch);
+    }
+
+    close_log_file();
 
     printf("\nDetector stopped.\n");
 
@@ -17,6 +17,9 @@
 #include <rte_mbuf.h>
 #include <rte_cycles.h>
 #include <rte_memory.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_atomic.h>
 
 #define RX_RING_SIZE 1024
 #define TX_RING_SIZE 8192
@@ -24,6 +27,8 @@
 #define MBUF_CACHE_SIZE 512
 #define BURST_SIZE 256
 #define MAX_PCAP_PACKETS 10000000
+#define MAX_TX_QUEUES 8
+#define MAX_SOURCES 8
 
 /* Target transmission rate: 12 Gbps for stable attack traffic */
 #define TARGET_GBPS 12.0
@@ -32,7 +37,31 @@ static volatile uint8_t force_quit = 0;
 static uint16_t port_id = 0;
 static struct rte_mempool *mbuf_pool = NULL;
 
-/* Statistics */
+/* NEW: Multi-lcore TX - one TX queue per slave lcore */
+static uint16_t num_tx_queues = 1;
+static uint16_t queue_ids[MAX_TX_QUEUES];
+
+/* NEW: Per-lcore TX state. Each lcore owns one queue and a striped cursor
+ * into the packet array (queue q sends packets q, q+N, q+2N, ...), so the
+ * hot path never shares a cache line with another lcore */
+struct tx_lcore_state {
+    uint64_t packets_sent;
+    uint64_t bytes_sent;
+    uint64_t src_packets[MAX_SOURCES];   /* Per-source accounting */
+    uint64_t src_bytes[MAX_SOURCES];
+    uint32_t src_idx[MAX_SOURCES];       /* Striped cursor per source */
+} __rte_cache_aligned;
+
+static struct tx_lcore_state g_tx[MAX_TX_QUEUES];
+
+/* NEW: Shared 1-second token window. Every TX lcore debits the same budget,
+ * so TARGET_GBPS remains the AGGREGATE rate across all queues. The main
+ * lcore resets the window */
+static rte_atomic64_t window_bytes;
+static volatile uint64_t rate_window_start_tsc = 0;
+static uint64_t target_bytes_per_sec = 0;
+
+/* Statistics (aggregated from per-lcore state by the main lcore) */
 static uint64_t total_packets_sent = 0;
 static uint64_t total_bytes_sent = 0;
 static uint64_t start_tsc = 0;
@@ -48,9 +77,45 @@ struct packet_data {
     uint16_t len;
 };
 
-static struct packet_data *pcap_packets = NULL;
-static uint32_t num_pcap_packets = 0;
-static uint32_t current_packet_idx = 0;
+/* NEW: Multiple weighted PCAP sources (--pcap file:weight, repeatable).
+ * Each source keeps its own packet array; the TX loops interleave them
+ * at transmit time, so a "70% benign / 30% mirai" scenario is a pair of
+ * command-line flags instead of a pre-merged multi-GB trace */
+struct pcap_source {
+    const char *path;
+    double weight;               /* Relative packet-count weight */
+    struct packet_data *packets;
+    uint32_t num_packets;
+};
+
+static struct pcap_source g_sources[MAX_SOURCES];
+static uint32_t num_sources = 0;
+
+/* NEW: Per-burst interleave schedule, built once from the normalized
+ * weights with smooth weighted round-robin - every burst carries the
+ * exact configured mix with the sources spread evenly through it, no
+ * RNG on the hot path */
+static uint8_t mix_schedule[BURST_SIZE];
+
+static void build_mix_schedule(void)
+{
+    double total = 0.0, credit[MAX_SOURCES] = {0};
+    uint32_t s, i;
+
+    for (s = 0; s < num_sources; s++)
+        total += g_sources[s].weight;
+
+    for (i = 0; i < BURST_SIZE; i++) {
+        uint32_t pick = 0;
+        for (s = 0; s < num_sources; s++) {
+            credit[s] += g_sources[s].weight / total;
+            if (credit[s] > credit[pick])
+                pick = s;
+        }
+        credit[pick] -= 1.0;
+        mix_schedule[i] = (uint8_t)pick;
+    }
+}
 
 /* Signal handler */
 static void signal_handler(int signum)
@@ -71,9 +136,10 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
         },
     };
 
-    const uint16_t rx_rings = 0, tx_rings = 1;
+    const uint16_t rx_rings = 0, tx_rings = num_tx_queues;
     uint16_t nb_txd = TX_RING_SIZE;
     int retval;
+    uint16_t q;
     struct rte_eth_dev_info dev_info;
 
     if (!rte_eth_dev_is_valid_port(port))
@@ -93,10 +159,13 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     if (retval != 0)
         return retval;
 
-    retval = rte_eth_tx_queue_setup(port, 0, nb_txd,
-            rte_eth_dev_socket_id(port), NULL);
-    if (retval < 0)
-        return retval;
+    /* NEW: One TX queue per TX lcore */
+    for (q = 0; q < tx_rings; q++) {
+        retval = rte_eth_tx_queue_setup(port, q, nb_txd,
+                rte_eth_dev_socket_id(port), NULL);
+        if (retval < 0)
+            return retval;
+    }
 
     retval = rte_eth_dev_start(port);
     if (retval < 0)
@@ -123,8 +192,8 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     return 0;
 }
 
-/* Load PCAP file into simple struct array */
-static int load_pcap(const char *filename)
+/* Load one PCAP source into its own simple struct array */
+static int load_pcap(struct pcap_source *src)
 {
     pcap_t *pcap;
     char errbuf[PCAP_ERRBUF_SIZE];
@@ -132,75 +201,104 @@ static int load_pcap(const char *filename)
     const u_char *data;
     int ret;
 
-    printf("Loading PCAP file: %s\n", filename);
+    printf("Loading PCAP file: %s (weight %.2f)\n", src->path, src->weight);
 
-    pcap = pcap_open_offline(filename, errbuf);
+    pcap = pcap_open_offline(src->path, errbuf);
     if (pcap == NULL) {
         printf("Error opening PCAP: %s\n", errbuf);
         return -1;
     }
 
-    pcap_packets = malloc(MAX_PCAP_PACKETS * sizeof(struct packet_data));
-    if (pcap_packets == NULL) {
+    src->packets = malloc(MAX_PCAP_PACKETS * sizeof(struct packet_data));
+    if (src->packets == NULL) {
         printf("Failed to allocate memory for PCAP packets\n");
         pcap_close(pcap);
         return -1;
     }
 
-    num_pcap_packets = 0;
+    src->num_packets = 0;
     while ((ret = pcap_next_ex(pcap, &header, &data)) >= 0) {
         if (ret == 0) continue;
 
-        if (num_pcap_packets >= MAX_PCAP_PACKETS) {
+        if (src->num_packets >= MAX_PCAP_PACKETS) {
             printf("Warning: PCAP has more than %d packets, truncating\n", MAX_PCAP_PACKETS);
             break;
         }
 
-        if (header->caplen > sizeof(pcap_packets[0].data)) {
+        if (header->caplen > sizeof(src->packets[0].data)) {
             printf("Warning: packet %u too large (%u bytes), skipping\n",
-                   num_pcap_packets, header->caplen);
+                   src->num_packets, header->caplen);
             continue;
         }
 
-        memcpy(pcap_packets[num_pcap_packets].data, data, header->caplen);
-        pcap_packets[num_pcap_packets].len = header->caplen;
-        num_pcap_packets++;
+        memcpy(src->packets[src->num_packets].data, data, header->caplen);
+        src->packets[src->num_packets].len = header->caplen;
+        src->num_packets++;
 
-        if (num_pcap_packets % 1000000 == 0)
-            printf("Loaded %u packets...\n", num_pcap_packets);
+        if (src->num_packets % 1000000 == 0)
+            printf("Loaded %u packets...\n", src->num_packets);
     }
 
     pcap_close(pcap);
-    printf("Loaded %u packets from PCAP\n", num_pcap_packets);
+    printf("Loaded %u packets from %s\n", src->num_packets, src->path);
+
+    if (src->num_packets == 0) {
+        printf("Error: %s contains no usable packets\n", src->path);
+        return -1;
+    }
     return 0;
 }
 
-/* Main sending loop with rate limiting */
-static void send_loop(void)
+/* NEW: Parse one --pcap argument of the form "file" or "file:weight".
+ * The weight is taken after the LAST colon and only if it parses as a
+ * positive number, so paths containing colons keep working */
+static int add_pcap_source(char *spec)
 {
+    double weight = 1.0;
+    char *colon = strrchr(spec, ':');
+
+    if (num_sources >= MAX_SOURCES) {
+        printf("Error: At most %d --pcap sources supported\n", MAX_SOURCES);
+        return -1;
+    }
+
+    if (colon != NULL && colon != spec) {
+        char *end = NULL;
+        double w = strtod(colon + 1, &end);
+        if (end != colon + 1 && *end == '\0' && w > 0) {
+            weight = w;
+            *colon = '\0';
+        }
+    }
+
+    g_sources[num_sources].path = spec;
+    g_sources[num_sources].weight = weight;
+    num_sources++;
+    return 0;
+}
+
+/* NEW: Per-lcore TX loop. Each lcore walks the weighted mix schedule,
+ * pulling the next striped packet from whichever source the slot names
+ * (order within each source is preserved per queue), sends on its own
+ * queue and debits the SHARED 1-second token budget, so the aggregate
+ * attack rate stays at TARGET_GBPS regardless of lcores */
+static int tx_loop(void *arg)
+{
+    uint16_t q = *(uint16_t *)arg;
+    struct tx_lcore_state *st = &g_tx[q];
     struct rte_mbuf *pkts[BURST_SIZE];
+    uint8_t slot_src[BURST_SIZE];
     uint16_t nb_tx;
-    uint32_t i;
+    uint32_t i, sidx;
     uint64_t hz = rte_get_tsc_hz();
-    uint64_t last_stats_tsc = 0;
+    uint64_t burst_bytes;
 
-    /* Rate limiting variables */
-    const uint64_t target_bytes_per_sec = (uint64_t)(TARGET_GBPS * 1e9 / 8.0);
-    uint64_t bytes_sent_in_window = 0;
-    uint64_t window_start_tsc = 0;
+    printf("TX lcore %u started (queue %u)\n", rte_lcore_id(), q);
 
-    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
-    printf("║   DPDK PCAP SENDER - %.1f Gbps ATTACK transmission        ║\n", TARGET_GBPS);
-    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
-    printf("Starting ATTACK packet transmission at %.1f Gbps...\n", TARGET_GBPS);
-    printf("Press Ctrl+C to stop\n\n");
-
-    start_tsc = rte_rdtsc();
-    last_stats_tsc = start_tsc;
-    window_start_tsc = start_tsc;
-    last_window_tsc = start_tsc;
-    last_window_packets = 0;
-    last_window_bytes = 0;
+    /* Striped partition per source: queue q sends packets q, q+N, q+2N,
+     * ... of each source, which preserves ordering within each stream */
+    for (sidx = 0; sidx < num_sources; sidx++)
+        st->src_idx[sidx] = q % g_sources[sidx].num_packets;
 
     while (!force_quit) {
         /* Allocate fresh mbufs */
@@ -209,29 +307,35 @@ static void send_loop(void)
             continue;
         }
 
-        /* Fill mbufs with PCAP data */
+        /* Fill mbufs following the weighted interleave schedule */
         for (i = 0; i < BURST_SIZE; i++) {
-            struct packet_data *pkt_data = &pcap_packets[current_packet_idx];
+            sidx = mix_schedule[i];
+            struct pcap_source *src = &g_sources[sidx];
+            struct packet_data *pkt_data = &src->packets[st->src_idx[sidx]];
 
             char *pkt_buf = rte_pktmbuf_mtod(pkts[i], char *);
             rte_memcpy(pkt_buf, pkt_data->data, pkt_data->len);
             pkts[i]->data_len = pkt_data->len;
             pkts[i]->pkt_len = pkt_data->len;
+            slot_src[i] = (uint8_t)sidx;
 
-            current_packet_idx++;
-            if (current_packet_idx >= num_pcap_packets)
-                current_packet_idx = 0;
+            st->src_idx[sidx] += num_tx_queues;
+            if (st->src_idx[sidx] >= src->num_packets)
+                st->src_idx[sidx] = q % src->num_packets;
         }
 
-        /* Send burst */
-        nb_tx = rte_eth_tx_burst(port_id, 0, pkts, BURST_SIZE);
-        total_packets_sent += nb_tx;
+        /* Send burst on our own queue */
+        nb_tx = rte_eth_tx_burst(port_id, q, pkts, BURST_SIZE);
+        st->packets_sent += nb_tx;
 
-        /* Track bytes for rate limiting */
+        /* Track bytes for rate limiting, split per source */
+        burst_bytes = 0;
         for (i = 0; i < nb_tx; i++) {
-            bytes_sent_in_window += pkts[i]->pkt_len;
-            total_bytes_sent += pkts[i]->pkt_len;
+            burst_bytes += pkts[i]->pkt_len;
+            st->src_packets[slot_src[i]]++;
+            st->src_bytes[slot_src[i]] += pkts[i]->pkt_len;
         }
+        st->bytes_sent += burst_bytes;
 
         /* Free unsent packets */
         if (unlikely(nb_tx < BURST_SIZE)) {
@@ -239,27 +343,102 @@ static void send_loop(void)
                 rte_pktmbuf_free(pkts[i]);
         }
 
-        /* Rate limiting */
+        /* Rate limiting against the shared aggregate budget */
+        uint64_t in_window = rte_atomic64_add_return(&window_bytes, burst_bytes);
         uint64_t cur_tsc = rte_rdtsc();
-        double elapsed_sec = (double)(cur_tsc - window_start_tsc) / hz;
+        double elapsed_sec = (double)(cur_tsc - rate_window_start_tsc) / hz;
 
-        if (elapsed_sec >= 1.0) {
-            /* Reset window every second */
-            bytes_sent_in_window = 0;
-            window_start_tsc = cur_tsc;
-        } else if (bytes_sent_in_window > (uint64_t)(target_bytes_per_sec * elapsed_sec)) {
+        if (elapsed_sec < 1.0 &&
+            in_window > (uint64_t)(target_bytes_per_sec * elapsed_sec)) {
             /* Too fast, calculate sleep time */
             double bytes_expected = target_bytes_per_sec * elapsed_sec;
-            double bytes_over = bytes_sent_in_window - bytes_expected;
+            double bytes_over = in_window - bytes_expected;
             uint64_t sleep_ns = (uint64_t)((bytes_over * 8.0 * 1e9) / (TARGET_GBPS * 1e9));
 
             if (sleep_ns > 0 && sleep_ns < 100000) {
                 rte_delay_us_block(sleep_ns / 1000);
             }
         }
+    }
+
+    return 0;
+}
+
+/* NEW: Aggregate per-lcore counters into the global statistics */
+static uint64_t total_src_packets[MAX_SOURCES];
+static uint64_t total_src_bytes[MAX_SOURCES];
+
+static void aggregate_tx_stats(void)
+{
+    uint16_t q;
+    uint32_t s;
+
+    total_packets_sent = 0;
+    total_bytes_sent = 0;
+    memset(total_src_packets, 0, sizeof(total_src_packets));
+    memset(total_src_bytes, 0, sizeof(total_src_bytes));
+    for (q = 0; q < num_tx_queues; q++) {
+        total_packets_sent += g_tx[q].packets_sent;
+        total_bytes_sent += g_tx[q].bytes_sent;
+        for (s = 0; s < num_sources; s++) {
+            total_src_packets[s] += g_tx[q].src_packets[s];
+            total_src_bytes[s] += g_tx[q].src_bytes[s];
+        }
+    }
+}
+
+/* NEW: Per-source rate accounting line (only shown for multi-PCAP runs) */
+static void print_source_stats(double elapsed)
+{
+    uint32_t s;
+
+    if (num_sources < 2)
+        return;
+
+    for (s = 0; s < num_sources; s++) {
+        double pct = total_packets_sent ?
+            100.0 * total_src_packets[s] / total_packets_sent : 0.0;
+        printf("         src[%u] %-32s %6.2f%% pkts | %.2f Gbps\n",
+               s, g_sources[s].path, pct,
+               (total_src_bytes[s] * 8.0) / (elapsed * 1e9));
+    }
+}
+
+/* Main lcore: resets the shared token window and prints statistics */
+static void stats_loop(void)
+{
+    uint64_t hz = rte_get_tsc_hz();
+    uint64_t last_stats_tsc = 0;
+
+    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
+    printf("║   DPDK PCAP SENDER - %.1f Gbps ATTACK transmission        ║\n", TARGET_GBPS);
+    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
+    printf("Starting ATTACK packet transmission at %.1f Gbps (%u TX lcores)...\n",
+           TARGET_GBPS, num_tx_queues);
+    printf("Press Ctrl+C to stop\n\n");
+
+    start_tsc = rte_rdtsc();
+    last_stats_tsc = start_tsc;
+    rate_window_start_tsc = start_tsc;
+    last_window_tsc = start_tsc;
+    last_window_packets = 0;
+    last_window_bytes = 0;
+
+    while (!force_quit) {
+        rte_delay_us_block(10000);
+
+        uint64_t cur_tsc = rte_rdtsc();
+
+        /* Reset the shared token window every second */
+        if ((double)(cur_tsc - rate_window_start_tsc) / hz >= 1.0) {
+            rte_atomic64_set(&window_bytes, 0);
+            rate_window_start_tsc = cur_tsc;
+        }
 
         /* Print statistics every 5 seconds */
         if (cur_tsc - last_stats_tsc >= hz * 5) {
+            aggregate_tx_stats();
+
             /* Cumulative statistics (from start) */
             double elapsed = (double)(cur_tsc - start_tsc) / hz;
             double gbps_cumulative = (total_bytes_sent * 8.0) / (elapsed * 1e9);
@@ -267,13 +446,12 @@ static void send_loop(void)
 
             /* Instantaneous statistics (last 5 seconds) */
             double window_duration = (double)(cur_tsc - last_window_tsc) / hz;
-            uint64_t window_packets = total_packets_sent - last_window_packets;
-            uint64_t window_bytes = total_bytes_sent - last_window_bytes;
-            double gbps_instant = (window_bytes * 8.0) / (window_duration * 1e9);
-            double mpps_instant = (window_packets / window_duration) / 1e6;
+            uint64_t window_bytes_5s = total_bytes_sent - last_window_bytes;
+            double gbps_instant = (window_bytes_5s * 8.0) / (window_duration * 1e9);
 
             printf("[%.1fs] Sent: %lu pkts (%.2f Mpps) | Cumulative: %.2f Gbps | Instant: %.2f Gbps | %lu bytes\n",
                    elapsed, total_packets_sent, mpps_cumulative, gbps_cumulative, gbps_instant, total_bytes_sent);
+            print_source_stats(elapsed);
 
             /* Update window markers */
             last_window_packets = total_packets_sent;
@@ -283,6 +461,10 @@ static void send_loop(void)
         }
     }
 
+    /* Wait for the TX lcores before reading their final counters */
+    rte_eal_mp_wait_lcore();
+    aggregate_tx_stats();
+
     printf("\n=== FINAL STATISTICS ===\n");
     double elapsed = (double)(rte_rdtsc() - start_tsc) / hz;
     double gbps = (total_bytes_sent * 8.0) / (elapsed * 1e9);
@@ -293,12 +475,14 @@ static void send_loop(void)
     printf("Duration:            %.2f seconds\n", elapsed);
     printf("Average throughput:  %.2f Gbps\n", gbps);
     printf("Average pps:         %.2f Mpps\n", mpps);
+    print_source_stats(elapsed);
 }
 
 int main(int argc, char *argv[])
 {
     int ret;
-    char *pcap_file = NULL;
+    unsigned lcore_id;
+    uint16_t q;
 
     ret = rte_eal_init(argc, argv);
     if (ret < 0)
@@ -307,19 +491,43 @@ int main(int argc, char *argv[])
     argc -= ret;
     argv += ret;
 
-    if (argc < 2) {
+    /* NEW: Repeatable --pcap file:weight sources; a bare positional
+     * path is still accepted as a single source with weight 1 */
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pcap") == 0 && i + 1 < argc) {
+            if (add_pcap_source(argv[++i]) != 0)
+                return -1;
+        } else if (argv[i][0] != '-') {
+            if (add_pcap_source(argv[i]) != 0)
+                return -1;
+        }
+    }
+
+    if (num_sources == 0) {
         printf("Usage: %s [EAL options] -- <pcap_file>\n", argv[0]);
+        printf("       %s [EAL options] -- --pcap benign.pcap:0.7 --pcap mirai.pcap:0.3\n",
+               argv[0]);
         return -1;
     }
 
-    pcap_file = argv[1];
-
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
     if (rte_eth_dev_count_avail() == 0)
         rte_exit(EXIT_FAILURE, "No Ethernet ports available\n");
 
+    /* NEW: One TX queue per slave lcore (main lcore handles statistics) */
+    if (rte_lcore_count() < 2)
+        rte_exit(EXIT_FAILURE,
+                 "Need at least 2 lcores (1 stats + 1 TX), e.g. -l 0-4\n");
+
+    num_tx_queues = rte_lcore_count() - 1;
+    if (num_tx_queues > MAX_TX_QUEUES)
+        num_tx_queues = MAX_TX_QUEUES;
+
+    target_bytes_per_sec = (uint64_t)(TARGET_GBPS * 1e9 / 8.0);
+    rte_atomic64_init(&window_bytes);
+
     mbuf_pool = rte_pktmbuf_pool_create("MBUF_POOL", NUM_MBUFS,
         MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
 
@@ -329,21 +537,46 @@ int main(int argc, char *argv[])
     if (port_init(port_id, mbuf_pool) != 0)
         rte_exit(EXIT_FAILURE, "Cannot init port %u\n", port_id);
 
-    if (load_pcap(pcap_file) != 0)
-        rte_exit(EXIT_FAILURE, "Failed to load PCAP file\n");
+    for (uint32_t s = 0; s < num_sources; s++) {
+        if (load_pcap(&g_sources[s]) != 0)
+            rte_exit(EXIT_FAILURE, "Failed to load PCAP file\n");
+    }
 
-    send_loop();
+    build_mix_schedule();
+    if (num_sources > 1) {
+        printf("\n[MIX] Interleaving %u sources per %d-packet burst:\n",
+               num_sources, BURST_SIZE);
+        double total_w = 0;
+        for (uint32_t s = 0; s < num_sources; s++)
+            total_w += g_sources[s].weight;
+        for (uint32_t s = 0; s < num_sources; s++)
+            printf("  src[%u] %-32s weight %.2f (%.1f%% of packets)\n",
+                   s, g_sources[s].path, g_sources[s].weight,
+                   100.0 * g_sources[s].weight / total_w);
+        printf("\n");
+    }
+
+    /* NEW: Launch one TX loop per slave lcore */
+    q = 0;
+    RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+        if (q >= num_tx_queues)
+            break;
+        queue_ids[q] = q;
+        rte_eal_remote_launch(tx_loop, &queue_ids[q], lcore_id);
+        q++;
+    }
+
+    stats_loop();
 
     /* Cleanup - INSTANTANEOUS */
     printf("Stopping port %u...\n", port_id);
     rte_eth_dev_stop(port_id);
     rte_eth_dev_close(port_id);
 
-    if (pcap_packets) {
-        printf("Freeing PCAP data...\n");
-        free(pcap_packets);  /* Single free - instant! */
-        printf("Cleanup complete.\n");
-    }
+    printf("Freeing PCAP data...\n");
+    for (uint32_t s = 0; s < num_sources; s++)
+        free(g_sources[s].packets);
+    printf("Cleanup complete.\n");
 
     printf("Sender stopped.\n");
     return 0;
@@ -17,6 +17,9 @@
 #include <rte_mbuf.h>
 #include <rte_cycles.h>
 #include <rte_memory.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_atomic.h>
 
 #define RX_RING_SIZE 1024
 #define TX_RING_SIZE 8192
@@ -24,6 +27,7 @@
 #define MBUF_CACHE_SIZE 512
 #define BURST_SIZE 256//512
 #define MAX_PCAP_PACKETS 10000000
+#define MAX_TX_QUEUES 8
 
 /* Target transmission rate: 17 Gbps (to achieve ~7 Gbps real at detector) */
 #define TARGET_GBPS 12.0//17
@@ -32,7 +36,29 @@ static volatile uint8_t force_quit = 0;
 static uint16_t port_id = 0;
 static struct rte_mempool *mbuf_pool = NULL;
 
-/* Statistics */
+/* NEW: Multi-lcore TX - one TX queue per slave lcore */
+static uint16_t num_tx_queues = 1;
+static uint16_t queue_ids[MAX_TX_QUEUES];
+
+/* NEW: Per-lcore TX state. Each lcore owns one queue and a striped cursor
+ * into the packet array (queue q sends packets q, q+N, q+2N, ...), so the
+ * hot path never shares a cache line with another lcore */
+struct tx_lcore_state {
+    uint64_t packets_sent;
+    uint64_t bytes_sent;
+    uint32_t pkt_idx;
+} __rte_cache_aligned;
+
+static struct tx_lcore_state g_tx[MAX_TX_QUEUES];
+
+/* NEW: Shared 1-second token window. Every TX lcore debits the same budget,
+ * so TARGET_GBPS remains the AGGREGATE rate across all queues. The main
+ * lcore resets the window */
+static rte_atomic64_t window_bytes;
+static volatile uint64_t rate_window_start_tsc = 0;
+static uint64_t target_bytes_per_sec = 0;
+
+/* Statistics (aggregated from per-lcore state by the main lcore) */
 static uint64_t total_packets_sent = 0;
 static uint64_t total_bytes_sent = 0;
 static uint64_t start_tsc = 0;
@@ -50,7 +76,6 @@ struct packet_data {
 
 static struct packet_data *pcap_packets = NULL;
 static uint32_t num_pcap_packets = 0;
-static uint32_t current_packet_idx = 0;
 
 /* Signal handler */
 static void signal_handler(int signum)
@@ -71,9 +96,10 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
         },
     };
 
-    const uint16_t rx_rings = 0, tx_rings = 1;
+    const uint16_t rx_rings = 0, tx_rings = num_tx_queues;
     uint16_t nb_txd = TX_RING_SIZE;
     int retval;
+    uint16_t q;
     struct rte_eth_dev_info dev_info;
 
     if (!rte_eth_dev_is_valid_port(port))
@@ -93,10 +119,13 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     if (retval != 0)
         return retval;
 
-    retval = rte_eth_tx_queue_setup(port, 0, nb_txd,
-            rte_eth_dev_socket_id(port), NULL);
-    if (retval < 0)
-        return retval;
+    /* NEW: One TX queue per TX lcore */
+    for (q = 0; q < tx_rings; q++) {
+        retval = rte_eth_tx_queue_setup(port, q, nb_txd,
+                rte_eth_dev_socket_id(port), NULL);
+        if (retval < 0)
+            return retval;
+    }
 
     retval = rte_eth_dev_start(port);
     if (retval < 0)
@@ -106,7 +135,7 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     if (retval != 0)
         return retval;
 
-    printf("Port %u initialized successfully\n", port);
+    printf("Port %u initialized successfully (%u TX queues)\n", port, tx_rings);
     return 0;
 }
 
@@ -162,32 +191,24 @@ static int load_pcap(const char *filename)
     return 0;
 }
 
-/* Main sending loop with rate limiting */
-static void send_loop(void)
+/* NEW: Per-lcore TX loop. Each lcore replays its stripe of the packet
+ * array on its own queue and debits the SHARED 1-second token budget, so
+ * the aggregate rate stays at TARGET_GBPS no matter how many lcores run */
+static int tx_loop(void *arg)
 {
+    uint16_t q = *(uint16_t *)arg;
+    struct tx_lcore_state *st = &g_tx[q];
     struct rte_mbuf *pkts[BURST_SIZE];
     uint16_t nb_tx;
     uint32_t i;
     uint64_t hz = rte_get_tsc_hz();
-    uint64_t last_stats_tsc = 0;
+    uint64_t burst_bytes;
 
-    /* Rate limiting variables */
-    const uint64_t target_bytes_per_sec = (uint64_t)(TARGET_GBPS * 1e9 / 8.0);
-    uint64_t bytes_sent_in_window = 0;
-    uint64_t window_start_tsc = 0;
-
-    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
-    printf("║      DPDK PCAP SENDER - %.1f Gbps baseline transmission     ║\n", TARGET_GBPS);
-    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
-    printf("Starting packet transmission at %.1f Gbps...\n", TARGET_GBPS);
-    printf("Press Ctrl+C to stop\n\n");
+    printf("TX lcore %u started (queue %u)\n", rte_lcore_id(), q);
 
-    start_tsc = rte_rdtsc();
-    last_stats_tsc = start_tsc;
-    window_start_tsc = start_tsc;
-    last_window_tsc = start_tsc;
-    last_window_packets = 0;
-    last_window_bytes = 0;
+    /* Striped partition: queue q sends packets q, q+N, q+2N, ... which
+     * preserves the PCAP ordering within each stream */
+    st->pkt_idx = q;
 
     while (!force_quit) {
         /* Allocate fresh mbufs */
@@ -198,27 +219,27 @@ static void send_loop(void)
 
         /* Fill mbufs with PCAP data */
         for (i = 0; i < BURST_SIZE; i++) {
-            struct packet_data *pkt_data = &pcap_packets[current_packet_idx];
+            struct packet_data *pkt_data = &pcap_packets[st->pkt_idx];
 
             char *pkt_buf = rte_pktmbuf_mtod(pkts[i], char *);
             rte_memcpy(pkt_buf, pkt_data->data, pkt_data->len);
             pkts[i]->data_len = pkt_data->len;
             pkts[i]->pkt_len = pkt_data->len;
 
-            current_packet_idx++;
-            if (current_packet_idx >= num_pcap_packets)
-                current_packet_idx = 0;
+            st->pkt_idx += num_tx_queues;
+            if (st->pkt_idx >= num_pcap_packets)
+                st->pkt_idx = q;
         }
 
-        /* Send burst */
-        nb_tx = rte_eth_tx_burst(port_id, 0, pkts, BURST_SIZE);
-        total_packets_sent += nb_tx;
+        /* Send burst on our own queue */
+        nb_tx = rte_eth_tx_burst(port_id, q, pkts, BURST_SIZE);
+        st->packets_sent += nb_tx;
 
         /* Track bytes for rate limiting */
-        for (i = 0; i < nb_tx; i++) {
-            bytes_sent_in_window += pkts[i]->pkt_len;
-            total_bytes_sent += pkts[i]->pkt_len;
-        }
+        burst_bytes = 0;
+        for (i = 0; i < nb_tx; i++)
+            burst_bytes += pkts[i]->pkt_len;
+        st->bytes_sent += burst_bytes;
 
         /* Free unsent packets */
         if (unlikely(nb_tx < BURST_SIZE)) {
@@ -226,27 +247,75 @@ static void send_loop(void)
                 rte_pktmbuf_free(pkts[i]);
         }
 
-        /* Rate limiting */
+        /* Rate limiting against the shared aggregate budget */
+        uint64_t in_window = rte_atomic64_add_return(&window_bytes, burst_bytes);
         uint64_t cur_tsc = rte_rdtsc();
-        double elapsed_sec = (double)(cur_tsc - window_start_tsc) / hz;
+        double elapsed_sec = (double)(cur_tsc - rate_window_start_tsc) / hz;
 
-        if (elapsed_sec >= 1.0) {
-            /* Reset window every second */
-            bytes_sent_in_window = 0;
-            window_start_tsc = cur_tsc;
-        } else if (bytes_sent_in_window > (uint64_t)(target_bytes_per_sec * elapsed_sec)) {
+        if (elapsed_sec < 1.0 &&
+            in_window > (uint64_t)(target_bytes_per_sec * elapsed_sec)) {
             /* Too fast, calculate sleep time */
             double bytes_expected = target_bytes_per_sec * elapsed_sec;
-            double bytes_over = bytes_sent_in_window - bytes_expected;
+            double bytes_over = in_window - bytes_expected;
             uint64_t sleep_ns = (uint64_t)((bytes_over * 8.0 * 1e9) / (TARGET_GBPS * 1e9));
 
             if (sleep_ns > 0 && sleep_ns < 100000) {
                 rte_delay_us_block(sleep_ns / 1000);
             }
         }
+    }
+
+    return 0;
+}
+
+/* NEW: Aggregate per-lcore counters into the global statistics */
+static void aggregate_tx_stats(void)
+{
+    uint16_t q;
+
+    total_packets_sent = 0;
+    total_bytes_sent = 0;
+    for (q = 0; q < num_tx_queues; q++) {
+        total_packets_sent += g_tx[q].packets_sent;
+        total_bytes_sent += g_tx[q].bytes_sent;
+    }
+}
+
+/* Main lcore: resets the shared token window and prints statistics */
+static void stats_loop(void)
+{
+    uint64_t hz = rte_get_tsc_hz();
+    uint64_t last_stats_tsc = 0;
+
+    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
+    printf("║      DPDK PCAP SENDER - %.1f Gbps baseline transmission     ║\n", TARGET_GBPS);
+    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
+    printf("Starting packet transmission at %.1f Gbps (%u TX lcores)...\n",
+           TARGET_GBPS, num_tx_queues);
+    printf("Press Ctrl+C to stop\n\n");
+
+    start_tsc = rte_rdtsc();
+    last_stats_tsc = start_tsc;
+    rate_window_start_tsc = start_tsc;
+    last_window_tsc = start_tsc;
+    last_window_packets = 0;
+    last_window_bytes = 0;
+
+    while (!force_quit) {
+        rte_delay_us_block(10000);
+
+        uint64_t cur_tsc = rte_rdtsc();
+
+        /* Reset the shared token window every second */
+        if ((double)(cur_tsc - rate_window_start_tsc) / hz >= 1.0) {
+            rte_atomic64_set(&window_bytes, 0);
+            rate_window_start_tsc = cur_tsc;
+        }
 
         /* Print statistics every 5 seconds */
         if (cur_tsc - last_stats_tsc >= hz * 5) {
+            aggregate_tx_stats();
+
             /* Cumulative statistics (from start) */
             double elapsed = (double)(cur_tsc - start_tsc) / hz;
             double gbps_cumulative = (total_bytes_sent * 8.0) / (elapsed * 1e9);
@@ -254,10 +323,8 @@ static void send_loop(void)
 
             /* Instantaneous statistics (last 5 seconds) */
             double window_duration = (double)(cur_tsc - last_window_tsc) / hz;
-            uint64_t window_packets = total_packets_sent - last_window_packets;
-            uint64_t window_bytes = total_bytes_sent - last_window_bytes;
-            double gbps_instant = (window_bytes * 8.0) / (window_duration * 1e9);
-            double mpps_instant = (window_packets / window_duration) / 1e6;
+            uint64_t window_bytes_5s = total_bytes_sent - last_window_bytes;
+            double gbps_instant = (window_bytes_5s * 8.0) / (window_duration * 1e9);
 
             printf("[%.1fs] Sent: %lu pkts (%.2f Mpps) | Cumulative: %.2f Gbps | Instant: %.2f Gbps | %lu bytes\n",
                    elapsed, total_packets_sent, mpps_cumulative, gbps_cumulative, gbps_instant, total_bytes_sent);
@@ -270,6 +337,10 @@ static void send_loop(void)
         }
     }
 
+    /* Wait for the TX lcores before reading their final counters */
+    rte_eal_mp_wait_lcore();
+    aggregate_tx_stats();
+
     printf("\n=== FINAL STATISTICS ===\n");
     double elapsed = (double)(rte_rdtsc() - start_tsc) / hz;
     double gbps = (total_bytes_sent * 8.0) / (elapsed * 1e9);
@@ -286,6 +357,8 @@ int main(int argc, char *argv[])
 {
     int ret;
     char *pcap_file = NULL;
+    unsigned lcore_id;
+    uint16_t q;
 
     ret = rte_eal_init(argc, argv);
     if (ret < 0)
@@ -307,6 +380,18 @@ int main(int argc, char *argv[])
     if (rte_eth_dev_count_avail() == 0)
         rte_exit(EXIT_FAILURE, "No Ethernet ports available\n");
 
+    /* NEW: One TX queue per slave lcore (main lcore handles statistics) */
+    if (rte_lcore_count() < 2)
+        rte_exit(EXIT_FAILURE,
+                 "Need at least 2 lcores (1 stats + 1 TX), e.g. -l 0-4\n");
+
+    num_tx_queues = rte_lcore_count() - 1;
+    if (num_tx_queues > MAX_TX_QUEUES)
+        num_tx_queues = MAX_TX_QUEUES;
+
+    target_bytes_per_sec = (uint64_t)(TARGET_GBPS * 1e9 / 8.0);
+    rte_atomic64_init(&window_bytes);
+
     mbuf_pool = rte_pktmbuf_pool_create("MBUF_POOL", NUM_MBUFS,
         MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
 
@@ -319,7 +404,17 @@ int main(int argc, char *argv[])
     if (load_pcap(pcap_file) != 0)
         rte_exit(EXIT_FAILURE, "Failed to load PCAP file\n");
 
-    send_loop();
+    /* NEW: Launch one TX loop per slave lcore */
+    q = 0;
+    RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+        if (q >= num_tx_queues)
+            break;
+        queue_ids[q] = q;
+        rte_eal_remote_launch(tx_loop, &queue_ids[q], lcore_id);
+        q++;
+    }
+
+    stats_loop();
 
     /* Cleanup - INSTANTANEOUS */
     printf("Stopping port %u...\n", port_id);
@@ -0,0 +1,207 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 MIRA Project
+ *
+ * Hardware mitigation - rte_flow drop rules for confirmed attackers
+ *
+ * When the coordinator confirms a heavy hitter it installs a per-source
+ * DROP rule on the NIC (Mellanox ConnectX class hardware handles these
+ * in the embedded switch), paired with a COUNT action so dropped
+ * traffic still shows up in the stats. Rules age out once the source
+ * goes quiet, so a spoofed address is never blocked forever.
+ */
+
+#ifndef MITIGATION_H
+#define MITIGATION_H
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_byteorder.h>
+#include <rte_cycles.h>
+#include <rte_flow.h>
+
+#define MITIGATION_MAX_RULES 64    /* Concurrent hardware drop rules */
+#define MITIGATION_AGE_SEC 10.0    /* Quiet time before a rule is removed */
+
+/* One installed hardware rule */
+struct mitigation_rule {
+    uint32_t src_ip;               /* Host byte order */
+    struct rte_flow *flow;
+    uint64_t installed_tsc;
+    uint64_t last_hit_count;       /* COUNT action reading at last check */
+    uint64_t last_active_tsc;      /* Last time the counter moved */
+    bool in_use;
+};
+
+struct mitigation_ctx {
+    uint16_t port;
+    bool enabled;
+    struct mitigation_rule rules[MITIGATION_MAX_RULES];
+    uint32_t active_rules;
+
+    /* Cumulative stats for reporting */
+    uint64_t total_installed;
+    uint64_t total_aged;
+    uint64_t hw_dropped_packets;
+    uint64_t hw_dropped_bytes;
+};
+
+static inline void mitigation_init(struct mitigation_ctx *ctx, uint16_t port,
+                                   bool enabled)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->port = port;
+    ctx->enabled = enabled;
+}
+
+/* Install a drop+count rule for one source IP. Idempotent: an IP that
+ * already has a rule just gets its activity timestamp refreshed */
+static inline int mitigation_block_ip(struct mitigation_ctx *ctx,
+                                      uint32_t src_ip, uint64_t cur_tsc)
+{
+    if (!ctx->enabled)
+        return -1;
+
+    int free_slot = -1;
+    for (int i = 0; i < MITIGATION_MAX_RULES; i++) {
+        if (ctx->rules[i].in_use) {
+            if (ctx->rules[i].src_ip == src_ip) {
+                ctx->rules[i].last_active_tsc = cur_tsc;
+                return 0;
+            }
+        } else if (free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0)
+        return -1;  /* Rule table full - keep the rules already working */
+
+    struct rte_flow_attr attr = {
+        .ingress = 1,
+    };
+
+    struct rte_flow_item_ipv4 ip_spec = {
+        .hdr.src_addr = rte_cpu_to_be_32(src_ip),
+    };
+    struct rte_flow_item_ipv4 ip_mask = {
+        .hdr.src_addr = RTE_BE32(0xffffffff),
+    };
+
+    struct rte_flow_item pattern[] = {
+        { .type = RTE_FLOW_ITEM_TYPE_ETH },
+        { .type = RTE_FLOW_ITEM_TYPE_IPV4,
+          .spec = &ip_spec, .mask = &ip_mask },
+        { .type = RTE_FLOW_ITEM_TYPE_END },
+    };
+
+    /* COUNT before DROP so the stats stay truthful for dropped traffic */
+    struct rte_flow_action_count count_conf = { 0 };
+    struct rte_flow_action actions[] = {
+        { .type = RTE_FLOW_ACTION_TYPE_COUNT, .conf = &count_conf },
+        { .type = RTE_FLOW_ACTION_TYPE_DROP },
+        { .type = RTE_FLOW_ACTION_TYPE_END },
+    };
+
+    struct rte_flow_error error;
+    if (rte_flow_validate(ctx->port, &attr, pattern, actions, &error) != 0) {
+        printf("[MITIGATION] NIC rejected drop rule: %s\n",
+               error.message ? error.message : "(no message)");
+        return -1;
+    }
+
+    struct rte_flow *flow = rte_flow_create(ctx->port, &attr, pattern,
+                                            actions, &error);
+    if (flow == NULL) {
+        printf("[MITIGATION] Failed to install drop rule: %s\n",
+               error.message ? error.message : "(no message)");
+        return -1;
+    }
+
+    struct mitigation_rule *rule = &ctx->rules[free_slot];
+    rule->src_ip = src_ip;
+    rule->flow = flow;
+    rule->installed_tsc = cur_tsc;
+    rule->last_hit_count = 0;
+    rule->last_active_tsc = cur_tsc;
+    rule->in_use = true;
+    ctx->active_rules++;
+    ctx->total_installed++;
+
+    printf("[MITIGATION] HW drop rule installed for %u.%u.%u.%u "
+           "(%u active rules)\n",
+           (src_ip >> 24) & 0xFF, (src_ip >> 16) & 0xFF,
+           (src_ip >> 8) & 0xFF, src_ip & 0xFF, ctx->active_rules);
+    return 0;
+}
+
+/* Poll rule counters and age out sources that went quiet. Call from the
+ * coordinator, roughly once per second */
+static inline void mitigation_age(struct mitigation_ctx *ctx,
+                                  uint64_t cur_tsc, uint64_t hz)
+{
+    if (!ctx->enabled || ctx->active_rules == 0)
+        return;
+
+    for (int i = 0; i < MITIGATION_MAX_RULES; i++) {
+        struct mitigation_rule *rule = &ctx->rules[i];
+        if (!rule->in_use)
+            continue;
+
+        struct rte_flow_action_count count_conf = { 0 };
+        struct rte_flow_action count_action = {
+            .type = RTE_FLOW_ACTION_TYPE_COUNT, .conf = &count_conf,
+        };
+        struct rte_flow_query_count query = { 0 };
+        struct rte_flow_error error;
+
+        if (rte_flow_query(ctx->port, rule->flow, &count_action,
+                           &query, &error) == 0) {
+            if (query.hits > rule->last_hit_count) {
+                ctx->hw_dropped_packets += query.hits - rule->last_hit_count;
+                if (query.bytes_set)
+                    ctx->hw_dropped_bytes = query.bytes;
+                rule->last_hit_count = query.hits;
+                rule->last_active_tsc = cur_tsc;
+            }
+        }
+
+        if ((double)(cur_tsc - rule->last_active_tsc) / hz >=
+            MITIGATION_AGE_SEC) {
+            uint32_t ip = rule->src_ip;
+
+            rte_flow_destroy(ctx->port, rule->flow, &error);
+            rule->in_use = false;
+            ctx->active_rules--;
+            ctx->total_aged++;
+
+            printf("[MITIGATION] Rule aged out for %u.%u.%u.%u "
+                   "(quiet %.0fs, %" PRIu64 " pkts dropped in HW)\n",
+                   (ip >> 24) & 0xFF, (ip >> 16) & 0xFF,
+                   (ip >> 8) & 0xFF, ip & 0xFF,
+                   MITIGATION_AGE_SEC, rule->last_hit_count);
+        }
+    }
+}
+
+/* Remove every installed rule (shutdown path) */
+static inline void mitigation_flush(struct mitigation_ctx *ctx)
+{
+    if (!ctx->enabled)
+        return;
+
+    struct rte_flow_error error;
+    rte_flow_flush(ctx->port, &error);
+
+    for (int i = 0; i < MITIGATION_MAX_RULES; i++)
+        ctx->rules[i].in_use = false;
+    ctx->active_rules = 0;
+
+    printf("[MITIGATION] Flushed all rules (%" PRIu64 " installed, "
+           "%" PRIu64 " aged, %" PRIu64 " pkts dropped in HW)\n",
+           ctx->total_installed, ctx->total_aged, ctx->hw_dropped_packets);
+}
+
+#endif /* MITIGATION_H */
@@ -0,0 +1,224 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 MIRA Project
+ *
+ * sketch_bench - in-process microbenchmarks for the sketch primitives
+ *
+ * Every perf claim in OPTIMIZATIONS.md so far came from eyeballing
+ * full-system logs on the CloudLab pair. This measures the primitives
+ * in isolation - octosketch_update_ip, octosketch_update_burst,
+ * octosketch_merge, octosketch_top_k, and the count-min update used by
+ * http_flood_detector - on synthesized batches so regressions show up
+ * without standing up two nodes and a NIC.
+ *
+ * No EAL init: the bench only needs rte_rdtsc() and the header-only
+ * sketches, so it runs on any box without hugepages. TSC frequency is
+ * calibrated against CLOCK_MONOTONIC instead of rte_get_tsc_hz().
+ *
+ * Run with: make bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+
+#include "octosketch.h"
+#include "../../common/count_min.h"
+
+#define BENCH_IPS (1u << 20)      /* IPs per synthesized batch */
+#define BENCH_BURST 32            /* mirrors the detector's RX burst slices */
+#define BENCH_WORKERS 14          /* same worker count as the detector */
+#define ZIPF_HOSTS 10000          /* client population for the zipf batch */
+#define ZIPF_ALPHA 1.0
+#define MERGE_ITERS 100
+#define TOPK_ITERS 1000
+
+/* Deterministic RNG (xorshift64*) so runs are comparable across machines */
+static uint64_t g_rng_state = 0x9e3779b97f4a7c15ULL;
+
+static inline uint64_t bench_rand(void)
+{
+    uint64_t x = g_rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    g_rng_state = x;
+    return x * 0x2545f4914f6cdd1dULL;
+}
+
+static inline double bench_rand_double(void)
+{
+    return (double)(bench_rand() >> 11) / (double)(1ULL << 53);
+}
+
+static uint64_t calibrate_tsc_hz(void)
+{
+    struct timespec t0, t1, req = { 0, 200 * 1000 * 1000 };
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64_t c0 = rte_rdtsc();
+    nanosleep(&req, NULL);
+    uint64_t c1 = rte_rdtsc();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double sec = (double)(t1.tv_sec - t0.tv_sec) +
+                 (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    return (uint64_t)((double)(c1 - c0) / sec);
+}
+
+/* --- Synthetic traffic distributions ---------------------------------- */
+
+/* Uniform: every packet from a random host in a 2^20 address pool.
+ * Near-worst case for the heavy part (no stable resident keys) */
+static void gen_uniform(uint32_t *ips, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        ips[i] = 0x0a000000 | (uint32_t)(bench_rand() & 0xfffff);
+}
+
+/* Zipfian over ZIPF_HOSTS clients: the realistic steady-state mix where
+ * a few talkers dominate. Sampled via inverse CDF + binary search */
+static void gen_zipf(uint32_t *ips, uint32_t n)
+{
+    static double cdf[ZIPF_HOSTS];
+    double sum = 0.0;
+
+    for (int h = 0; h < ZIPF_HOSTS; h++) {
+        sum += 1.0 / pow((double)(h + 1), ZIPF_ALPHA);
+        cdf[h] = sum;
+    }
+    for (int h = 0; h < ZIPF_HOSTS; h++)
+        cdf[h] /= sum;
+
+    for (uint32_t i = 0; i < n; i++) {
+        double u = bench_rand_double();
+        int lo = 0, hi = ZIPF_HOSTS - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        ips[i] = 0xc0a80000 | (uint32_t)lo;
+    }
+}
+
+/* Spoofed-source flood: every packet a fresh random /32, the Mirai-style
+ * pattern that maximizes dirty blocks and heavy-part churn */
+static void gen_spoofed(uint32_t *ips, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        ips[i] = (uint32_t)bench_rand();
+}
+
+/* --- Benchmarks ------------------------------------------------------- */
+
+static double g_tsc_hz;
+
+static void report(const char *name, uint64_t cycles, uint64_t ops)
+{
+    double per_op = (double)cycles / (double)ops;
+    double mops = g_tsc_hz / per_op / 1e6;
+    printf("  %-26s %10.1f cycles/op %10.2f Mops/s\n", name, per_op, mops);
+}
+
+static struct octosketch *alloc_sketch(const char *name)
+{
+    void *mem = NULL;
+
+    if (posix_memalign(&mem, RTE_CACHE_LINE_SIZE, sizeof(struct octosketch)) != 0) {
+        fprintf(stderr, "Error: cannot allocate sketch\n");
+        exit(1);
+    }
+    octosketch_init((struct octosketch *)mem, name);
+    return (struct octosketch *)mem;
+}
+
+static void bench_distribution(const char *label,
+                               void (*gen)(uint32_t *, uint32_t))
+{
+    uint32_t *ips = malloc(BENCH_IPS * sizeof(uint32_t));
+    if (ips == NULL) {
+        fprintf(stderr, "Error: cannot allocate IP batch\n");
+        exit(1);
+    }
+    gen(ips, BENCH_IPS);
+
+    printf("=== %s (%u packets) ===\n", label, BENCH_IPS);
+
+    /* Scalar per-packet update (the pre-burst hot path) */
+    struct octosketch *sk = alloc_sketch("bench");
+    uint64_t t0 = rte_rdtsc();
+    for (uint32_t i = 0; i < BENCH_IPS; i++)
+        octosketch_update_ip(sk, ips[i], 1);
+    report("octosketch_update_ip", rte_rdtsc() - t0, BENCH_IPS);
+
+    /* Burst update in detector-sized slices */
+    octosketch_reset(sk);
+    t0 = rte_rdtsc();
+    for (uint32_t i = 0; i < BENCH_IPS; i += BENCH_BURST)
+        octosketch_update_burst(sk, &ips[i], BENCH_BURST, 1);
+    report("octosketch_update_burst", rte_rdtsc() - t0, BENCH_IPS);
+    free(sk);
+
+    /* Count-min update (http_flood_detector per-packet path) */
+    struct count_min_sketch *cms = cms_init();
+    if (cms == NULL) {
+        fprintf(stderr, "Error: cannot allocate count-min sketch\n");
+        exit(1);
+    }
+    t0 = rte_rdtsc();
+    for (uint32_t i = 0; i < BENCH_IPS; i++)
+        cms_update(cms, ips[i], 1);
+    report("cms_update", rte_rdtsc() - t0, BENCH_IPS);
+    cms_free(cms);
+
+    /* Coordinator merge + Top-K: stripe the batch across worker sketches
+     * the way RSS does, then merge repeatedly. Dirty-block coverage (and
+     * therefore merge cost) depends heavily on the distribution */
+    struct octosketch *workers[BENCH_WORKERS];
+    struct octosketch *merged = alloc_sketch("merged");
+    for (int w = 0; w < BENCH_WORKERS; w++)
+        workers[w] = alloc_sketch("worker");
+    for (uint32_t i = 0; i < BENCH_IPS; i++)
+        octosketch_update_ip(workers[i % BENCH_WORKERS], ips[i], 1);
+
+    t0 = rte_rdtsc();
+    for (int it = 0; it < MERGE_ITERS; it++)
+        octosketch_merge(merged, workers, BENCH_WORKERS);
+    report("octosketch_merge", rte_rdtsc() - t0, MERGE_ITERS);
+
+    struct heavy_hitter top[SKETCH_TOP_K];
+    t0 = rte_rdtsc();
+    for (int it = 0; it < TOPK_ITERS; it++)
+        octosketch_top_k(merged, SKETCH_TOP_K, top);
+    report("octosketch_top_k", rte_rdtsc() - t0, TOPK_ITERS);
+
+    for (int w = 0; w < BENCH_WORKERS; w++)
+        free(workers[w]);
+    free(merged);
+    free(ips);
+    printf("\n");
+}
+
+int main(void)
+{
+    g_tsc_hz = (double)calibrate_tsc_hz();
+
+    printf("Sketch microbenchmarks - TSC %.2f GHz, %d workers, burst %d\n",
+           g_tsc_hz / 1e9, BENCH_WORKERS, BENCH_BURST);
+    printf("octosketch: %zu bytes, count-min: %zu bytes\n\n",
+           octosketch_memory_size(), sizeof(struct count_min_sketch));
+
+    bench_distribution("uniform (2^20 host pool)", gen_uniform);
+    bench_distribution("zipfian (10k hosts, a=1.0)", gen_zipf);
+    bench_distribution("spoofed (random /32 flood)", gen_spoofed);
+
+    return 0;
+}
@@ -39,9 +39,11 @@
 #include <rte_atomic.h>
 #include <rte_hash.h>
 #include <rte_jhash.h>
+#include <rte_ring.h>
 
 #include "octosketch.h"
 #include "ml_inference.h"  /* ========== ML INTEGRATION ========== */
+#include "../../common/telemetry.h"
 
 #define RX_RING_SIZE 32768       /* Max for uint16_t compatibility (must be power of 2) */
 #define TX_RING_SIZE 4096
@@ -243,12 +245,83 @@ static ml_model_handle g_ml_model = NULL;
 #define ML_CONFIDENCE_THRESHOLD 0.75f
 /* ========================================================== */
 
+/* ========== ML INTEGRATION: Async inference pipeline ==========
+ * The coordinator NEVER calls ml_predict() inline: it enqueues feature
+ * snapshots to a dedicated inference lcore and reads the latest
+ * prediction back through a seqlock'd slot, so detection cadence never
+ * depends on model latency (first-call warmup, large ensembles) */
+#define ML_RING_SIZE 64   /* power of 2; >3 s of 50 ms snapshots */
+
+struct ml_result_slot {
+    volatile uint32_t seq;       /* Seqlock: odd = write in progress */
+    int status;                  /* Return code of last ml_predict() */
+    struct ml_prediction pred;
+    uint64_t produced_tsc;
+};
+
+static struct rte_ring *g_ml_ring = NULL;   /* coordinator -> inference lcore */
+static struct ml_features g_ml_feature_slots[ML_RING_SIZE];
+static uint32_t g_ml_feature_idx;
+static struct ml_result_slot g_ml_result __rte_cache_aligned;
+/* ============================================================== */
+
+/* ========== ML INTEGRATION: Per-flow feature pipeline ==========
+ * Window-global features can say "there is a SYN flood" but never which
+ * flows constitute it, so mixed attack+benign windows classify poorly.
+ * Workers aggregate per-flow counters (keyed by struct flow_key) in a
+ * static arena - open addressing, bounded probes, NO malloc and no
+ * variable-length anything on the worker side. Once a flow has been
+ * tracked for FLOW_EXPORT_SEC it is condensed into a fixed-size feature
+ * record and handed to the inference lcore through an MP/SC ring, which
+ * issues per-flow verdicts alongside the window-global ones */
+#define FLOW_TABLE_SIZE 4096      /* Entries per worker (power of 2) */
+#define FLOW_TABLE_MASK (FLOW_TABLE_SIZE - 1)
+#define FLOW_PROBES 8             /* Bounded open-addressing probes */
+#define FLOW_EXPORT_SEC 1.0       /* Per-flow aggregation window */
+#define FLOW_RING_SIZE 8192       /* power of 2 */
+#define FLOW_MIN_PKTS 32          /* Don't bother the model with dribbles */
+#define FLOW_DRAIN_BATCH 256      /* Max records per inference-loop pass */
+
+struct flow_entry {
+    struct flow_key key;
+    uint64_t first_seen_tsc;
+    uint64_t bytes;
+    uint32_t packets;
+    uint32_t syn_packets;
+    bool in_use;
+};
+
+/* Fixed-size record handed to the inference lcore */
+struct flow_record {
+    struct flow_key key;          /* src_ip host order, ports raw (BE) */
+    float pps;
+    float bytes_per_pkt;
+    float syn_ratio;
+    float duration_sec;
+    uint32_t packets;
+};
+
+/* Static arenas in BSS - each worker only ever touches its own row.
+ * There are as many record slots per worker as the ring holds in total,
+ * so a slot can never be recycled while its pointer is still enqueued */
+static struct flow_entry g_flow_table[NUM_RX_QUEUES][FLOW_TABLE_SIZE] __rte_cache_aligned;
+static struct flow_record g_flow_slots[NUM_RX_QUEUES][FLOW_RING_SIZE];
+static uint32_t g_flow_slot_idx[NUM_RX_QUEUES];
+static struct rte_ring *g_flow_ring = NULL;   /* workers (MP) -> inference lcore (SC) */
+static uint64_t g_flow_verdicts;              /* inference lcore only */
+static uint64_t g_flow_flagged;               /* inference lcore only */
+/* ============================================================== */
+
+static struct telemetry_ctx g_telemetry;
+
 /* Sampling configuration */
 #define SKETCH_SAMPLE_RATE 32  /* Update sketch every N packets (1 in 32) */
 
 /* Function declarations */
 static int worker_thread(void *arg);
 static int coordinator_thread(void *arg);
+static int ml_inference_thread(void *arg);
+static bool ml_read_latest(struct ml_prediction *out);
 static void signal_handler(int signum);
 static void print_stats(uint16_t port, uint64_t cur_tsc, uint64_t hz);
 static void detect_attacks(uint64_t cur_tsc, uint64_t hz);
@@ -431,7 +504,7 @@ static void detect_attacks(uint64_t cur_tsc, uint64_t hz)
         bool ml_alert = false;
         const char *ml_class_name = "unknown";
         float ml_confidence = 0.0f;
-        struct ml_prediction ml_pred;
+        struct ml_prediction ml_pred = {0};
         uint64_t window_total_pkts = window_base_pkts + window_att_pkts;
         uint64_t window_total_bytes = 0;
 
@@ -441,23 +514,28 @@ static void detect_attacks(uint64_t cur_tsc, uint64_t hz)
         }
 
         if (g_ml_model != NULL && window_total_pkts > 100) {
-            // Build features from window statistics
-            struct ml_features features;
+            // Build features into the next snapshot slot
+            struct ml_features *features =
+                &g_ml_feature_slots[g_ml_feature_idx & (ML_RING_SIZE - 1)];
             uint64_t window_tcp_pkts = 0;
             for (int i = 0; i < NUM_RX_QUEUES; i++) {
                 window_tcp_pkts += g_worker_stats[i].tcp_packets;
             }
 
-            ml_build_features(&features,
+            ml_build_features(features,
                 window_total_pkts, window_total_bytes,
                 window_udp_pkts, window_tcp_pkts, window_icmp_pkts,
                 window_syn_pkts, window_http_reqs,
                 window_base_pkts, window_att_pkts);
 
-            // Run ML prediction (LOCAL, in-process)
-            int ret = ml_predict(g_ml_model, &features, &ml_pred);
+            /* Hand off to the inference lcore - NEVER block on the model.
+             * A full ring just drops the snapshot; a fresher one follows
+             * on the next pass */
+            if (rte_ring_enqueue(g_ml_ring, features) == 0)
+                g_ml_feature_idx++;
 
-            if (ret == 0) {
+            /* Non-blocking read of the latest published prediction */
+            if (ml_read_latest(&ml_pred)) {
                 ml_class_name = ml_get_class_name(ml_pred.predicted_class);
                 ml_confidence = ml_pred.confidence;
 
@@ -496,6 +574,30 @@ static void detect_attacks(uint64_t cur_tsc, uint64_t hz)
         }
         /* ========================================================== */
 
+        /* Publish the interval snapshot to the binary telemetry ring.
+         * aux[6..7] carry the ML class and confidence */
+        struct telemetry_record trec = {0};
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        trec.tsc = cur_tsc;
+        trec.wall_ns = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+        trec.alert_level = g_stats.alert_level;
+        trec.total_packets = g_stats.total_packets;
+        trec.total_bytes = g_stats.total_bytes;
+        trec.baseline_packets = g_stats.baseline_packets;
+        trec.attack_packets = g_stats.attack_packets;
+        trec.nic_rx_dropped = g_stats.rx_dropped_nic;
+        trec.throughput_gbps = g_stats.throughput_gbps;
+        trec.aux[0] = attack_pps;
+        trec.aux[1] = syn_pps;
+        trec.aux[2] = udp_pps;
+        trec.aux[3] = icmp_pps;
+        trec.aux[4] = http_pps;
+        trec.aux[5] = ml_alert ? 1.0 : 0.0;
+        trec.aux[6] = (double)ml_pred.predicted_class;
+        trec.aux[7] = ml_confidence;
+        telemetry_publish(&g_telemetry, &trec);
+
         /* Detection timestamp tracking - EVERY detection */
         if (attack_detected) {
             g_stats.total_detection_events++;
@@ -948,6 +1050,72 @@ static void print_stats(uint16_t port, uint64_t cur_tsc, uint64_t hz)
     last_window_reset_tsc = cur_tsc;
 }
 
+/* Export a finished flow: condense the arena entry into a fixed-size
+ * record and enqueue its pointer. Ring full = drop the record; the flow
+ * just starts a fresh window on its next packet */
+static inline void flow_export(uint16_t queue_id, struct flow_entry *fe,
+                               uint64_t now_tsc, uint64_t hz)
+{
+    if (fe->packets >= FLOW_MIN_PKTS && g_flow_ring != NULL) {
+        struct flow_record *rec =
+            &g_flow_slots[queue_id][g_flow_slot_idx[queue_id] & (FLOW_RING_SIZE - 1)];
+        double dur = (double)(now_tsc - fe->first_seen_tsc) / hz;
+
+        if (dur < 1e-3)
+            dur = 1e-3;
+        rec->key = fe->key;
+        rec->pps = (float)((double)fe->packets / dur);
+        rec->bytes_per_pkt = (float)((double)fe->bytes / fe->packets);
+        rec->syn_ratio = (float)fe->syn_packets / (float)fe->packets;
+        rec->duration_sec = (float)dur;
+        rec->packets = fe->packets;
+        if (rte_ring_enqueue(g_flow_ring, rec) == 0)
+            g_flow_slot_idx[queue_id]++;
+    }
+    fe->in_use = false;
+}
+
+/* Account one packet against this worker's flow arena. Open addressing
+ * with bounded probes; a full neighbourhood exports and evicts its
+ * oldest entry instead of allocating anything */
+static inline void flow_touch(uint16_t queue_id, const struct flow_key *key,
+                              uint16_t pkt_len, uint8_t tcp_flags,
+                              uint64_t now_tsc, uint64_t hz)
+{
+    uint32_t h = rte_jhash(key, sizeof(*key), 0x51a7e57a);
+    struct flow_entry *row = g_flow_table[queue_id];
+    struct flow_entry *victim = NULL;
+
+    for (int i = 0; i < FLOW_PROBES; i++) {
+        struct flow_entry *fe = &row[(h + i) & FLOW_TABLE_MASK];
+
+        if (fe->in_use && memcmp(&fe->key, key, sizeof(*key)) == 0) {
+            fe->packets++;
+            fe->bytes += pkt_len;
+            fe->syn_packets += (tcp_flags & RTE_TCP_SYN_FLAG) ? 1 : 0;
+            if ((double)(now_tsc - fe->first_seen_tsc) / hz >= FLOW_EXPORT_SEC)
+                flow_export(queue_id, fe, now_tsc, hz);
+            return;
+        }
+        if (!fe->in_use) {
+            victim = fe;
+            break;
+        }
+        if (victim == NULL || fe->first_seen_tsc < victim->first_seen_tsc)
+            victim = fe;
+    }
+
+    /* New flow (evicting the oldest neighbour when the probes are full) */
+    if (victim->in_use)
+        flow_export(queue_id, victim, now_tsc, hz);
+    victim->key = *key;
+    victim->first_seen_tsc = now_tsc;
+    victim->bytes = pkt_len;
+    victim->packets = 1;
+    victim->syn_packets = (tcp_flags & RTE_TCP_SYN_FLAG) ? 1 : 0;
+    victim->in_use = true;
+}
+
 /* Worker thread - RX processing */
 static int worker_thread(void *arg)
 {
@@ -970,6 +1138,9 @@ static int worker_thread(void *arg)
     /* Sampling counter for sketch updates */
     uint64_t sample_counter = 0;
 
+    /* TSC frequency for per-flow export windows */
+    uint64_t hz = rte_get_tsc_hz();
+
     printf("Worker thread %u processing queue %u on lcore %u\n",
            queue_id, queue_id, rte_lcore_id());
 
@@ -983,6 +1154,9 @@ static int worker_thread(void *arg)
             continue;
         }
 
+        /* One timestamp per burst is enough for flow windows */
+        uint64_t burst_tsc = rte_rdtsc();
+
         /* Prefetch first 16 packets for better pipeline */
         for (uint16_t i = 0; i < nb_rx && i < 16; i++) {
             rte_prefetch0(rte_pktmbuf_mtod(bufs[i], void *));
@@ -1033,6 +1207,9 @@ static int worker_thread(void *arg)
             }
 
             /* Parse transport layer - OPTIMIZED for CPU efficiency */
+            uint16_t fl_src_port = 0, fl_dst_port = 0;   /* Raw (BE) */
+            uint8_t fl_tcp_flags = 0;
+
             if (likely(proto == IPPROTO_TCP)) {
                 local_tcp_pkts++;
                 struct rte_tcp_hdr *tcp_hdr = (struct rte_tcp_hdr *)((uint8_t *)ip_hdr + sizeof(struct rte_ipv4_hdr));
@@ -1049,6 +1226,10 @@ static int worker_thread(void *arg)
 
                 /* HTTP detection - use raw port (avoid byte swap if possible) */
                 local_http_reqs += (dst_port_raw == rte_cpu_to_be_16(80)) ? 1 : 0;
+
+                fl_src_port = tcp_hdr->src_port;
+                fl_dst_port = dst_port_raw;
+                fl_tcp_flags = tcp_flags;
             }
             else if (proto == IPPROTO_UDP) {
                 local_udp_pkts++;
@@ -1057,11 +1238,28 @@ static int worker_thread(void *arg)
                 /* DNS detection - check both ports at once */
                 uint16_t dns_port = rte_cpu_to_be_16(53);
                 local_dns_queries += ((udp_hdr->dst_port == dns_port) | (udp_hdr->src_port == dns_port)) ? 1 : 0;
+
+                fl_src_port = udp_hdr->src_port;
+                fl_dst_port = udp_hdr->dst_port;
             }
             else if (proto == IPPROTO_ICMP) {
                 local_icmp_pkts++;
             }
 
+            /* Per-flow feature pipeline: one arena update per packet.
+             * Only flows the model can issue verdicts on (TCP/UDP) */
+            if (g_flow_ring != NULL &&
+                (proto == IPPROTO_TCP || proto == IPPROTO_UDP)) {
+                struct flow_key fkey = {
+                    .src_ip = src_ip,
+                    .src_port = fl_src_port,
+                    .dst_port = fl_dst_port,
+                    .proto = proto,
+                };
+                flow_touch(queue_id, &fkey, pkt_len, fl_tcp_flags,
+                           burst_tsc, hz);
+            }
+
             /* OctoSketch update: ONLY for attack traffic + sampled (1 in N packets) */
             if (unlikely(is_attack)) {
                 sample_counter++;
@@ -1127,6 +1325,120 @@ static int worker_thread(void *arg)
 }
 
 /* Coordinator thread - Detection and stats */
+/* ========== ML INTEGRATION: Inference lcore ==========
+ * Blocks on the model so the coordinator does not have to. Predictions
+ * are published under a seqlock (odd sequence while writing) */
+static int ml_inference_thread(__rte_unused void *arg)
+{
+    printf("ML inference thread on lcore %u\n", rte_lcore_id());
+
+    while (!force_quit) {
+        struct ml_features *features;
+        bool idle = true;
+
+        ml_model_handle model = g_ml_model;
+        if (model == NULL) {
+            rte_delay_us_block(1000);
+            continue;
+        }
+
+        /* Window-global snapshot from the coordinator */
+        if (rte_ring_dequeue(g_ml_ring, (void **)&features) == 0) {
+            struct ml_prediction pred;
+            int ret = ml_predict(model, features, &pred);
+
+            g_ml_result.seq++;
+            rte_smp_wmb();
+            g_ml_result.status = ret;
+            g_ml_result.pred = pred;
+            g_ml_result.produced_tsc = rte_rdtsc();
+            rte_smp_wmb();
+            g_ml_result.seq++;
+            idle = false;
+        }
+
+        /* Per-flow records from the workers. Bounded batch so window
+         * snapshots never wait behind a flood of flow verdicts */
+        struct flow_record *rec;
+        int drained = 0;
+        while (g_flow_ring != NULL && drained < FLOW_DRAIN_BATCH &&
+               rte_ring_dequeue(g_flow_ring, (void **)&rec) == 0) {
+            struct ml_features feat;
+            struct ml_prediction fpred;
+            uint32_t pkts = rec->packets;
+            uint32_t network = rec->key.src_ip & NETWORK_MASK;
+
+            drained++;
+
+            /* Same feature builder as the window path, fed with the
+             * single-flow aggregates */
+            ml_build_features(&feat, pkts,
+                (uint64_t)((double)rec->bytes_per_pkt * pkts),
+                rec->key.proto == IPPROTO_UDP ? pkts : 0,
+                rec->key.proto == IPPROTO_TCP ? pkts : 0,
+                0,
+                (uint64_t)(rec->syn_ratio * pkts),
+                (rec->key.proto == IPPROTO_TCP &&
+                 rec->key.dst_port == rte_cpu_to_be_16(80)) ? pkts : 0,
+                network == BASELINE_NETWORK ? pkts : 0,
+                network == ATTACK_NETWORK ? pkts : 0);
+
+            if (ml_predict(model, &feat, &fpred) != 0)
+                continue;
+            g_flow_verdicts++;
+
+            if (fpred.predicted_class != 0 &&
+                fpred.confidence >= ML_CONFIDENCE_THRESHOLD) {
+                uint32_t ip = rec->key.src_ip;
+
+                g_flow_flagged++;
+                printf("[ML-FLOW] %u.%u.%u.%u:%u -> :%u  %s (%.0f%%)  "
+                       "%.0f pps, %.0f B/pkt, syn %.2f, %.1fs\n",
+                       (ip >> 24) & 0xff, (ip >> 16) & 0xff,
+                       (ip >> 8) & 0xff, ip & 0xff,
+                       rte_be_to_cpu_16(rec->key.src_port),
+                       rte_be_to_cpu_16(rec->key.dst_port),
+                       ml_get_class_name(fpred.predicted_class),
+                       fpred.confidence * 100.0,
+                       rec->pps, rec->bytes_per_pkt,
+                       rec->syn_ratio, rec->duration_sec);
+            }
+        }
+        if (drained > 0)
+            idle = false;
+
+        if (idle)
+            rte_delay_us_block(1000);  /* 1ms - snapshots arrive every 50ms */
+    }
+
+    printf("[ML] Per-flow verdicts: %" PRIu64 " issued, %" PRIu64 " flagged\n",
+           g_flow_verdicts, g_flow_flagged);
+
+    return 0;
+}
+
+/* Non-blocking seqlock read of the latest prediction. Returns false if
+ * no valid prediction has been published yet or a write is in flight
+ * (caller keeps using its previous copy) */
+static bool ml_read_latest(struct ml_prediction *out)
+{
+    uint32_t seq_before, seq_after;
+    int status;
+
+    do {
+        seq_before = g_ml_result.seq;
+        if (seq_before == 0 || (seq_before & 1))
+            return false;
+        rte_smp_rmb();
+        status = g_ml_result.status;
+        *out = g_ml_result.pred;
+        rte_smp_rmb();
+        seq_after = g_ml_result.seq;
+    } while (seq_before != seq_after);
+
+    return status == 0;
+}
+
 static int coordinator_thread(__rte_unused void *arg)
 {
     uint16_t port = 0;
@@ -1276,6 +1588,10 @@ int main(int argc, char *argv[])
     if (!g_log_file)
         printf("Warning: Could not open log file\n");
 
+    /* Binary telemetry ring next to the text log (50ms records) */
+    telemetry_open(&g_telemetry, "../results/detectorML_telemetry.bin",
+                   "detectorML");
+
     /* Initialize atomics */
     memset(&g_stats, 0, sizeof(g_stats));
     memset(g_ip_table, 0, sizeof(g_ip_table));
@@ -1318,6 +1634,27 @@ int main(int argc, char *argv[])
         printf("[ML] Model loaded successfully - ML-enhanced detection enabled\n");
         printf("[ML] Confidence threshold: %.2f\n", ML_CONFIDENCE_THRESHOLD);
         printf("[ML] Hybrid mode: Thresholds + LightGBM classifier\n");
+
+        /* Feature snapshot ring: coordinator (SP) -> inference lcore (SC) */
+        g_ml_ring = rte_ring_create("ml_features", ML_RING_SIZE,
+                rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+        if (g_ml_ring == NULL) {
+            printf("[ML] Warning: Cannot create feature ring, ML disabled\n");
+            ml_cleanup(g_ml_model);
+            g_ml_model = NULL;
+        } else {
+            printf("[ML] Async inference pipeline: ring depth %d, seqlock result slot\n",
+                   ML_RING_SIZE);
+
+            /* Per-flow record ring: 14 worker producers, 1 consumer */
+            g_flow_ring = rte_ring_create("flow_records", FLOW_RING_SIZE,
+                    rte_socket_id(), RING_F_SC_DEQ);
+            if (g_flow_ring == NULL)
+                printf("[ML] Warning: Cannot create flow ring - per-flow verdicts disabled\n");
+            else
+                printf("[ML] Per-flow pipeline: %d-entry arena per worker, ring depth %d\n",
+                       FLOW_TABLE_SIZE, FLOW_RING_SIZE);
+        }
     }
     printf("\n");
     /* ================================================= */
@@ -1341,17 +1678,19 @@ int main(int argc, char *argv[])
 
     unsigned lcore_idx = 0;
     unsigned coordinator_lcore = 0;
+    unsigned ml_lcore = 0;
 
-    /* First pass: launch workers */
+    /* First pass: launch workers, then reserve coordinator + ML lcores */
     RTE_LCORE_FOREACH_SLAVE(lcore_id) {
         if (lcore_idx < NUM_RX_QUEUES) {
             /* Worker thread */
             printf("Launching worker %u on lcore %u\n", lcore_idx, lcore_id);
             rte_eal_remote_launch(worker_thread, &queue_ids[lcore_idx], lcore_id);
             lcore_idx++;
-        } else {
-            /* Save coordinator lcore for next pass */
+        } else if (coordinator_lcore == 0) {
             coordinator_lcore = lcore_id;
+        } else {
+            ml_lcore = lcore_id;
             break;
         }
     }
@@ -1364,6 +1703,18 @@ int main(int argc, char *argv[])
         printf("Warning: No lcore available for coordinator thread!\n");
     }
 
+    /* Launch ML inference thread - model stalls never touch detection */
+    if (g_ml_model != NULL) {
+        if (ml_lcore > 0) {
+            printf("Launching ML inference thread on lcore %u\n", ml_lcore);
+            rte_eal_remote_launch(ml_inference_thread, NULL, ml_lcore);
+        } else {
+            printf("Warning: No lcore for ML inference thread - ML disabled\n");
+            ml_cleanup(g_ml_model);
+            g_ml_model = NULL;
+        }
+    }
+
     /* Wait for all threads */
     rte_eal_mp_wait_lcore();
 
@@ -1371,6 +1722,9 @@ int main(int argc, char *argv[])
         fclose(g_log_file);
 
     rte_hash_free(ip_hash);
+    rte_ring_free(g_ml_ring);
+    rte_ring_free(g_flow_ring);
+    telemetry_close(&g_telemetry);
     printf("\nShutting down...\n");
     rte_eal_cleanup();
 
@@ -1,10 +1,17 @@
 /**
- * ML Inference Implementation using LightGBM C API
- * EMBEDDED - no external processes
+ * ML Inference Implementation - flattened LightGBM tree ensemble
+ * EMBEDDED - no external processes, no LightGBM runtime
+ *
+ * ml_init() parses the LightGBM text model (lightgbm_model.txt) once
+ * and flattens every tree into contiguous structure-of-arrays node
+ * tables (feature index, threshold, child offsets, leaf values).
+ * ml_predict() then walks each tree with a branch-free conditional
+ * select per level - a handful of cmovs over cache-resident arrays
+ * instead of a generic booster call, so a prediction costs well under
+ * a microsecond and can run per heavy-hitter flow if needed.
  */
 
 #include "ml_inference.h"
-#include <LightGBM/c_api.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,40 +21,205 @@ static const char *CLASS_NAMES[] = {
     "benign", "udp_flood", "syn_flood", "icmp_flood", "mixed_attack"
 };
 
+/* Flattened ensemble: all trees share one node arena. Child encoding
+ * follows LightGBM: index >= 0 is an internal node (absolute into the
+ * arena), index < 0 is a leaf whose value sits at leaf_value[~index] */
 struct ml_model_handle_internal {
-    BoosterHandle booster;
     int num_features;
     int num_classes;
+    int num_trees;
+
+    int32_t *tree_root;       /* Per tree: arena node index or ~leaf */
+    int32_t *node_feature;
+    float   *node_threshold;
+    int32_t *node_left;
+    int32_t *node_right;
+    float   *leaf_value;
+
+    int total_nodes;
+    int total_leaves;
 };
 
+/* ===== LightGBM text model parsing helpers ===== */
+
+/* Find "key=" at the start of a line inside [p, end) and return a
+ * pointer just past the '='; NULL if not found */
+static const char *find_key(const char *p, const char *end, const char *key)
+{
+    size_t klen = strlen(key);
+
+    while (p < end) {
+        if ((size_t)(end - p) > klen &&
+            strncmp(p, key, klen) == 0 && p[klen] == '=')
+            return p + klen + 1;
+        p = memchr(p, '\n', end - p);
+        if (!p)
+            return NULL;
+        p++;
+    }
+    return NULL;
+}
+
+static int parse_int_field(const char *p, const char *end, const char *key,
+                           int *out)
+{
+    const char *v = find_key(p, end, key);
+    if (!v)
+        return -1;
+    *out = (int)strtol(v, NULL, 10);
+    return 0;
+}
+
+/* Parse a space-separated array of n values after "key=". Values land
+ * in out_i (ints) or out_f (floats), whichever is non-NULL */
+static int parse_array_field(const char *p, const char *end, const char *key,
+                             int n, int32_t *out_i, float *out_f)
+{
+    const char *v = find_key(p, end, key);
+    if (!v)
+        return -1;
+
+    for (int i = 0; i < n; i++) {
+        char *next;
+        double val = strtod(v, &next);
+        if (next == v)
+            return -1;
+        if (out_i)
+            out_i[i] = (int32_t)val;
+        if (out_f)
+            out_f[i] = (float)val;
+        v = next;
+    }
+    return 0;
+}
+
 ml_model_handle ml_init(const char *model_path)
 {
+    FILE *f = fopen(model_path, "rb");
+    if (!f) {
+        fprintf(stderr, "[ML] Failed to load model from %s\n", model_path);
+        return NULL;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char *buf = malloc(file_size + 1);
+    if (!buf || fread(buf, 1, file_size, f) != (size_t)file_size) {
+        fprintf(stderr, "[ML] Failed to read model file\n");
+        free(buf);
+        fclose(f);
+        return NULL;
+    }
+    buf[file_size] = '\0';
+    fclose(f);
+
     struct ml_model_handle_internal *model = calloc(1, sizeof(*model));
     if (!model) {
-        fprintf(stderr, "[ML] Failed to allocate model\n");
+        free(buf);
         return NULL;
     }
 
-    int num_iterations = 0;
-    int ret = LGBM_BoosterCreateFromModelfile(model_path, &num_iterations, &model->booster);
-    if (ret != 0) {
-        fprintf(stderr, "[ML] Failed to load model from %s\n", model_path);
-        free(model);
-        return NULL;
+    const char *end = buf + file_size;
+    int max_feature_idx = 0;
+
+    if (parse_int_field(buf, end, "num_class", &model->num_classes) != 0 ||
+        parse_int_field(buf, end, "max_feature_idx", &max_feature_idx) != 0) {
+        fprintf(stderr, "[ML] Model header missing num_class/max_feature_idx\n");
+        goto fail;
     }
+    model->num_features = max_feature_idx + 1;
 
-    ret = LGBM_BoosterGetNumFeature(model->booster, &model->num_features);
-    ret |= LGBM_BoosterGetNumClasses(model->booster, &model->num_classes);
+    /* First pass: count trees and total nodes/leaves to size the arena */
+    int num_trees = 0, total_nodes = 0, total_leaves = 0;
+    for (const char *p = buf; (p = find_key(p, end, "Tree")) != NULL; ) {
+        int num_leaves = 0;
+        if (parse_int_field(p, end, "num_leaves", &num_leaves) != 0)
+            goto fail;
+        num_trees++;
+        total_leaves += num_leaves;
+        total_nodes += num_leaves - 1;   /* Binary tree: leaves-1 splits */
+        const char *nl = memchr(p, '\n', end - p);
+        p = nl ? nl + 1 : end;
+    }
 
-    if (ret != 0) {
-        fprintf(stderr, "[ML] Failed to get model metadata\n");
-        LGBM_BoosterFree(model->booster);
-        free(model);
-        return NULL;
+    if (num_trees == 0) {
+        fprintf(stderr, "[ML] No trees found in model file\n");
+        goto fail;
     }
 
-    printf("[ML] Model loaded: %d features, %d classes\n", model->num_features, model->num_classes);
+    model->num_trees = num_trees;
+    model->total_nodes = total_nodes;
+    model->total_leaves = total_leaves;
+    model->tree_root = malloc(num_trees * sizeof(int32_t));
+    model->node_feature = malloc(total_nodes * sizeof(int32_t));
+    model->node_threshold = malloc(total_nodes * sizeof(float));
+    model->node_left = malloc(total_nodes * sizeof(int32_t));
+    model->node_right = malloc(total_nodes * sizeof(int32_t));
+    model->leaf_value = malloc(total_leaves * sizeof(float));
+
+    if (!model->tree_root || !model->node_feature || !model->node_threshold ||
+        !model->node_left || !model->node_right || !model->leaf_value)
+        goto fail;
+
+    /* Second pass: flatten each tree into the arena, rebasing child
+     * indices to absolute arena positions */
+    int node_base = 0, leaf_base = 0, tree_idx = 0;
+    for (const char *p = buf; (p = find_key(p, end, "Tree")) != NULL; ) {
+        int num_leaves = 0;
+        if (parse_int_field(p, end, "num_leaves", &num_leaves) != 0)
+            goto fail;
+
+        int num_nodes = num_leaves - 1;
+
+        if (num_nodes > 0) {
+            int32_t *feat = &model->node_feature[node_base];
+            float *thresh = &model->node_threshold[node_base];
+            int32_t *left = &model->node_left[node_base];
+            int32_t *right = &model->node_right[node_base];
+
+            if (parse_array_field(p, end, "split_feature", num_nodes, feat, NULL) != 0 ||
+                parse_array_field(p, end, "threshold", num_nodes, NULL, thresh) != 0 ||
+                parse_array_field(p, end, "left_child", num_nodes, left, NULL) != 0 ||
+                parse_array_field(p, end, "right_child", num_nodes, right, NULL) != 0)
+                goto fail;
+
+            for (int i = 0; i < num_nodes; i++) {
+                left[i] = (left[i] >= 0) ? left[i] + node_base
+                                         : ~(~left[i] + leaf_base);
+                right[i] = (right[i] >= 0) ? right[i] + node_base
+                                           : ~(~right[i] + leaf_base);
+            }
+            model->tree_root[tree_idx] = node_base;
+        } else {
+            /* Degenerate single-leaf tree: root is the leaf itself */
+            model->tree_root[tree_idx] = ~leaf_base;
+        }
+
+        if (parse_array_field(p, end, "leaf_value", num_leaves,
+                              NULL, &model->leaf_value[leaf_base]) != 0)
+            goto fail;
+
+        node_base += num_nodes;
+        leaf_base += num_leaves;
+        tree_idx++;
+        const char *nl = memchr(p, '\n', end - p);
+        p = nl ? nl + 1 : end;
+    }
+
+    free(buf);
+    printf("[ML] Model loaded: %d features, %d classes\n",
+           model->num_features, model->num_classes);
+    printf("[ML] Flattened ensemble: %d trees, %d nodes, %d leaves (%.1f KB)\n",
+           model->num_trees, model->total_nodes, model->total_leaves,
+           (model->total_nodes * 16 + model->total_leaves * 4) / 1024.0);
     return (ml_model_handle)model;
+
+fail:
+    free(buf);
+    ml_cleanup((ml_model_handle)model);
+    return NULL;
 }
 
 int ml_predict(ml_model_handle handle, const struct ml_features *features, struct ml_prediction *prediction)
@@ -57,7 +229,7 @@ int ml_predict(ml_model_handle handle, const struct ml_features *features, struc
     struct ml_model_handle_internal *model = (struct ml_model_handle_internal*)handle;
 
     // Convert features to array
-    double feature_array[ML_NUM_FEATURES] = {
+    float feature_array[ML_NUM_FEATURES] = {
         features->total_packets, features->total_bytes,
         features->udp_packets, features->tcp_packets, features->icmp_packets,
         features->syn_packets, features->http_requests,
@@ -66,34 +238,45 @@ int ml_predict(ml_model_handle handle, const struct ml_features *features, struc
         features->baseline_attack_ratio, features->bytes_per_packet
     };
 
-    int64_t out_len;
-    double out_result[ML_NUM_CLASSES];
-
-    int ret = LGBM_BoosterPredictForMat(
-        model->booster,
-        feature_array,
-        C_API_DTYPE_FLOAT64,
-        1,                    // nrow
-        ML_NUM_FEATURES,     // ncol
-        1,                    // is_row_major
-        C_API_PREDICT_NORMAL,
-        0,                    // start_iteration
-        -1,                   // num_iteration (use best)
-        "",                   // parameter
-        &out_len,
-        out_result
-    );
-
-    if (ret != 0 || out_len != model->num_classes) {
+    if (model->num_classes > ML_NUM_CLASSES)
         return -1;
+
+    double scores[ML_NUM_CLASSES] = {0};
+
+    /* Trees are class-major (tree t scores class t % num_classes). Each
+     * level is one conditional select over the flat arrays - the ternary
+     * compiles to cmov, so traversal never mispredicts */
+    for (int t = 0; t < model->num_trees; t++) {
+        int32_t node = model->tree_root[t];
+
+        while (node >= 0) {
+            int go_left = feature_array[model->node_feature[node]] <=
+                          model->node_threshold[node];
+            node = go_left ? model->node_left[node] : model->node_right[node];
+        }
+        scores[t % model->num_classes] += model->leaf_value[~node];
+    }
+
+    /* Softmax over raw scores (multiclass objective) */
+    double max_score = scores[0];
+    for (int i = 1; i < model->num_classes; i++)
+        if (scores[i] > max_score)
+            max_score = scores[i];
+
+    double sum = 0.0;
+    double probs[ML_NUM_CLASSES];
+    for (int i = 0; i < model->num_classes; i++) {
+        probs[i] = exp(scores[i] - max_score);
+        sum += probs[i];
     }
 
     // Find argmax
     int max_idx = 0;
-    double max_prob = out_result[0];
-    for (int i = 1; i < model->num_classes; i++) {
-        if (out_result[i] > max_prob) {
-            max_prob = out_result[i];
+    double max_prob = 0.0;
+    for (int i = 0; i < model->num_classes; i++) {
+        probs[i] /= sum;
+        if (probs[i] > max_prob) {
+            max_prob = probs[i];
             max_idx = i;
         }
     }
@@ -101,7 +284,7 @@ int ml_predict(ml_model_handle handle, const struct ml_features *features, struc
     prediction->predicted_class = max_idx;
     prediction->confidence = (float)max_prob;
     for (int i = 0; i < ML_NUM_CLASSES; i++) {
-        prediction->probabilities[i] = (float)out_result[i];
+        prediction->probabilities[i] = (i < model->num_classes) ? (float)probs[i] : 0.0f;
     }
 
     return 0;
@@ -111,7 +294,12 @@ void ml_cleanup(ml_model_handle handle)
 {
     if (handle) {
         struct ml_model_handle_internal *model = (struct ml_model_handle_internal*)handle;
-        LGBM_BoosterFree(model->booster);
+        free(model->tree_root);
+        free(model->node_feature);
+        free(model->node_threshold);
+        free(model->node_left);
+        free(model->node_right);
+        free(model->leaf_value);
         free(model);
         printf("[ML] Model cleaned up\n");
     }
@@ -4,6 +4,12 @@
  * Detector de ataques QUIC Optimistic ACK usando reglas precisas sin ML
  * Optimizado para 100 Gbps con NICs Mellanox
  *
+ * Architecture (same scheme as mira/detector_system/mira_ddos_detector.c):
+ * - 14 Worker threads: RX via RSS, frame parsing, per-worker sketches and
+ *   per-worker partitions of the per-IP QUIC state (NO atomics - RSS on
+ *   source IP guarantees each IP always hits the same worker)
+ * - 1 Coordinator thread: aggregates workers and evaluates the rules
+ *
  * Reglas de deteccion:
  * 1. ACK Rate Anomaly: Tasa de ACKs por IP > umbral
  * 2. Bytes Ratio Anomaly: bytes_out/bytes_in desbalanceado
@@ -53,11 +59,15 @@
 #include <rte_hash.h>
 #include <rte_jhash.h>
 
+#include "../../common/count_min.h"
+#include "../../common/telemetry.h"
+
 #define RX_RING_SIZE 8192        /* Increased from 4096 to reduce drops */
 #define TX_RING_SIZE 4096
 #define NUM_MBUFS 524288
 #define MBUF_CACHE_SIZE 512
 #define BURST_SIZE 512
+#define NUM_RX_QUEUES 14         /* 14 workers + 1 coordinator, like MIRA */
 
 /* QUIC ports */
 #define QUIC_PORT_443 443
@@ -71,11 +81,12 @@
 #define QUIC_FRAME_ACK 0x02
 #define QUIC_FRAME_ACK_ECN 0x03
 
-/* OctoSketch parameters */
-#define SKETCH_WIDTH 65536    // 64K buckets
-#define SKETCH_DEPTH 4        // 4 hash functions
+/* OctoSketch parameters (CMS_WIDTH/CMS_DEPTH come from count_min.h) */
 #define HEAVY_HITTER_THRESHOLD 5000   // ACKs para ser heavy hitter (por ventana) - was 10000
 
+/* Per-worker partition of the per-IP QUIC state */
+#define MAX_IPS_PER_WORKER 8192
+
 /* Detection thresholds - ADJUSTED for real Optimistic ACK attack patterns */
 #define ACK_RATE_THRESHOLD 10000      // >10K ACKs per IP in 5s window = suspicious
 #define BYTES_RATIO_THRESHOLD 2.2     // bytes_out/bytes_in > 2.2 = attack (baseline ~1.0, RFC 9000 limit = 3.0)
@@ -97,13 +108,6 @@
 #define ALERT_HIGH 3
 #define ALERT_CRITICAL 4
 
-/* Count-Min Sketch para conteo de frecuencias */
-struct count_min_sketch {
-    uint32_t width;
-    uint32_t depth;
-    uint32_t **counters;
-};
-
 /* Per-IP statistics for QUIC traffic */
 struct ip_quic_stats {
     uint64_t ack_count;           // Total ACKs sent by this IP
@@ -115,7 +119,44 @@ struct ip_quic_stats {
     uint64_t last_burst_check;    // TSC of last burst check
 };
 
-/* Detection statistics */
+/* Per-worker state - sketches, counters and an rte_hash partition of the
+ * per-IP QUIC state. RSS hashes on source IP so a given client always
+ * lands on the same worker: no atomics, no cross-worker sharing, and the
+ * coordinator can simply sum per-worker counts */
+struct worker_state {
+    struct count_min_sketch *ip_ack_sketch;      // ACKs per IP
+    struct count_min_sketch *ip_bytes_in_sketch; // Bytes sent by IP
+    struct count_min_sketch *ip_bytes_out_sketch;// Bytes received by IP
+
+    struct rte_hash *ip_hash;                    // IP -> index into ip_stats
+    struct ip_quic_stats *ip_stats;              // Per-IP QUIC state partition
+
+    /* Cumulative counters (coordinator computes window deltas) */
+    uint64_t total_packets;
+    uint64_t quic_packets;
+    uint64_t baseline_packets;  // 192.168.x.x (legitimate)
+    uint64_t attack_packets;    // 203.0.113.x (attack)
+    uint64_t total_acks;
+    uint64_t total_bytes_in;    // Client -> Server
+    uint64_t total_bytes_out;   // Server -> Client
+    uint64_t short_packets;
+    uint64_t long_packets;
+    uint64_t unique_ips;
+    uint64_t heavy_hitters;
+    uint64_t suspicious_ips;    // Packet-number-jump events (attack IPs)
+    uint64_t burst_detections;  // ACK burst events
+
+    /* Maximum values observed */
+    uint64_t max_ack_rate;
+    uint64_t max_pkt_num_jump;
+
+    /* CPU / RX accounting */
+    uint64_t total_processing_cycles;
+    uint64_t rx_bursts_total;
+    uint64_t rx_bursts_empty;
+} __rte_cache_aligned;
+
+/* Detection statistics - coordinator aggregate */
 struct detection_stats {
     /* Counters */
     uint64_t total_packets;
@@ -194,19 +235,23 @@ struct detector_config {
     bool verbose;
 } g_config = {
     .port_id = 0,
-    .nb_queues = 1,
+    .nb_queues = NUM_RX_QUEUES,
     .verbose = false,
 };
 
 /* Global state */
 static volatile bool force_quit = false;
 static FILE *g_log_file = NULL;
+static struct telemetry_ctx g_telemetry;
 static struct rte_mempool *mbuf_pool = NULL;
-static struct count_min_sketch *ip_ack_sketch = NULL;      // ACKs per IP
-static struct count_min_sketch *ip_bytes_in_sketch = NULL; // Bytes sent by IP
-static struct count_min_sketch *ip_bytes_out_sketch = NULL;// Bytes received by IP
+static struct worker_state g_workers[NUM_RX_QUEUES] __rte_cache_aligned;
 static struct detection_stats g_stats;
 
+/* Window baselines - cumulative worker totals at last window reset */
+static uint64_t window_base_unique_ips = 0;
+static uint64_t window_base_heavy_hitters = 0;
+static uint64_t window_base_suspicious_ips = 0;
+
 /* Forward declarations */
 static void close_log_file(void);
 
@@ -280,82 +325,6 @@ static void dual_printf(const char *format, ...)
     }
 }
 
-/* Initialize Count-Min Sketch */
-static struct count_min_sketch *cms_init(uint32_t width, uint32_t depth)
-{
-    struct count_min_sketch *cms = malloc(sizeof(*cms));
-    if (!cms)
-        return NULL;
-
-    cms->width = width;
-    cms->depth = depth;
-
-    cms->counters = malloc(depth * sizeof(uint32_t *));
-    if (!cms->counters) {
-        free(cms);
-        return NULL;
-    }
-
-    for (uint32_t i = 0; i < depth; i++) {
-        cms->counters[i] = calloc(width, sizeof(uint32_t));
-        if (!cms->counters[i]) {
-            for (uint32_t j = 0; j < i; j++)
-                free(cms->counters[j]);
-            free(cms->counters);
-            free(cms);
-            return NULL;
-        }
-    }
-
-    return cms;
-}
-
-/* Update Count-Min Sketch */
-static void cms_update(struct count_min_sketch *cms, uint32_t item, uint32_t count)
-{
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        uint32_t hash = rte_jhash_1word(item, i);
-        uint32_t index = hash % cms->width;
-        cms->counters[i][index] += count;
-    }
-}
-
-/* Query Count-Min Sketch */
-static uint32_t cms_query(struct count_min_sketch *cms, uint32_t item)
-{
-    uint32_t min_count = UINT32_MAX;
-
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        uint32_t hash = rte_jhash_1word(item, i);
-        uint32_t index = hash % cms->width;
-        if (cms->counters[i][index] < min_count)
-            min_count = cms->counters[i][index];
-    }
-
-    return min_count;
-}
-
-/* Reset Count-Min Sketch */
-static void cms_reset(struct count_min_sketch *cms)
-{
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        memset(cms->counters[i], 0, cms->width * sizeof(uint32_t));
-    }
-}
-
-/* Free Count-Min Sketch */
-static void cms_free(struct count_min_sketch *cms)
-{
-    if (!cms)
-        return;
-
-    for (uint32_t i = 0; i < cms->depth; i++) {
-        free(cms->counters[i]);
-    }
-    free(cms->counters);
-    free(cms);
-}
-
 /* Check if packet is QUIC based on heuristics */
 static bool is_quic_packet(uint8_t *payload, uint32_t len)
 {
@@ -469,7 +438,62 @@ static int parse_quic_for_acks(uint8_t *payload, uint32_t len,
     return *ack_count;
 }
 
-/* Detect QUIC Optimistic ACK attack using multiple rules */
+/* Aggregate per-worker counters into g_stats - COORDINATOR ONLY */
+static void aggregate_worker_stats(void)
+{
+    uint64_t unique_ips = 0, heavy_hitters = 0, suspicious_ips = 0;
+
+    g_stats.total_packets = 0;
+    g_stats.quic_packets = 0;
+    g_stats.baseline_packets = 0;
+    g_stats.attack_packets = 0;
+    g_stats.total_acks = 0;
+    g_stats.total_bytes_in = 0;
+    g_stats.total_bytes_out = 0;
+    g_stats.short_packets = 0;
+    g_stats.long_packets = 0;
+    g_stats.burst_detections = 0;
+    g_stats.max_ack_rate = 0;
+    g_stats.max_pkt_num_jump = 0;
+    g_stats.total_processing_cycles = 0;
+    g_stats.rx_bursts_total = 0;
+    g_stats.rx_bursts_empty = 0;
+
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        struct worker_state *ws = &g_workers[w];
+
+        g_stats.total_packets += ws->total_packets;
+        g_stats.quic_packets += ws->quic_packets;
+        g_stats.baseline_packets += ws->baseline_packets;
+        g_stats.attack_packets += ws->attack_packets;
+        g_stats.total_acks += ws->total_acks;
+        g_stats.total_bytes_in += ws->total_bytes_in;
+        g_stats.total_bytes_out += ws->total_bytes_out;
+        g_stats.short_packets += ws->short_packets;
+        g_stats.long_packets += ws->long_packets;
+        g_stats.burst_detections += ws->burst_detections;
+        g_stats.total_processing_cycles += ws->total_processing_cycles;
+        g_stats.rx_bursts_total += ws->rx_bursts_total;
+        g_stats.rx_bursts_empty += ws->rx_bursts_empty;
+
+        unique_ips += ws->unique_ips;
+        heavy_hitters += ws->heavy_hitters;
+        suspicious_ips += ws->suspicious_ips;
+
+        if (ws->max_ack_rate > g_stats.max_ack_rate)
+            g_stats.max_ack_rate = ws->max_ack_rate;
+        if (ws->max_pkt_num_jump > g_stats.max_pkt_num_jump)
+            g_stats.max_pkt_num_jump = ws->max_pkt_num_jump;
+    }
+
+    /* Per-window values: delta against counts at last window reset.
+     * RSS on source IP means no IP is counted by two workers */
+    g_stats.unique_ips = unique_ips - window_base_unique_ips;
+    g_stats.heavy_hitters = heavy_hitters - window_base_heavy_hitters;
+    g_stats.suspicious_ips = suspicious_ips - window_base_suspicious_ips;
+}
+
+/* Detect QUIC Optimistic ACK attack using multiple rules - COORDINATOR ONLY */
 static void detect_optimistic_ack(void)
 {
     uint64_t cur_tsc = rte_rdtsc();
@@ -481,6 +505,8 @@ static void detect_optimistic_ack(void)
     if (fast_elapsed >= FAST_DETECTION_INTERVAL) {
         g_stats.last_fast_detection_tsc = cur_tsc;
 
+        aggregate_worker_stats();
+
         /* Calculate current ratio for fast detection */
         double bytes_ratio = 0.0;
         if (g_stats.total_bytes_in > 0) {
@@ -624,18 +650,43 @@ reset_window:
 
     /* Reset window */
     g_stats.window_start_tsc = cur_tsc;
-    g_stats.unique_ips = 0;
-    g_stats.heavy_hitters = 0;
-    g_stats.suspicious_ips = 0;
-
-    /* Reset sketches */
-    cms_reset(ip_ack_sketch);
-    cms_reset(ip_bytes_in_sketch);
-    cms_reset(ip_bytes_out_sketch);
+
+    /* New window baseline for per-window deltas */
+    window_base_unique_ips = 0;
+    window_base_heavy_hitters = 0;
+    window_base_suspicious_ips = 0;
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        window_base_unique_ips += g_workers[w].unique_ips;
+        window_base_heavy_hitters += g_workers[w].heavy_hitters;
+        window_base_suspicious_ips += g_workers[w].suspicious_ips;
+    }
+
+    /* Reset per-worker sketches and window-local maxima. Racy with the
+     * workers' updates, but a lost increment at the window edge is noise
+     * at these rates (same tolerance as the MIRA detector) */
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        cms_reset(g_workers[w].ip_ack_sketch);
+        cms_reset(g_workers[w].ip_bytes_in_sketch);
+        cms_reset(g_workers[w].ip_bytes_out_sketch);
+        g_workers[w].max_ack_rate = 0;
+    }
 }
 
-/* Process packet and extract features */
-static void process_packet(struct rte_mbuf *pkt)
+/* Process packet and extract features - runs on the owning worker only */
+/* Per-packet work carried from the parse pass to the per-IP pass */
+struct quic_pkt_info {
+    uint32_t src_ip;
+    uint32_t pkt_len;
+    uint64_t ack_count;
+    uint64_t largest_ack;
+    bool is_attack;
+};
+
+/* Pass 1: parse + classify + sketch updates. Everything except the
+ * per-IP rte_hash state, which is resolved in bulk afterwards. Returns
+ * true if the packet carries ACKs and needs the per-IP pass */
+static bool process_packet_parse(struct worker_state *ws, struct rte_mbuf *pkt,
+                                 struct quic_pkt_info *info)
 {
     struct rte_ether_hdr *eth_hdr;
     struct rte_ipv4_hdr *ipv4_hdr;
@@ -643,17 +694,17 @@ static void process_packet(struct rte_mbuf *pkt)
     uint8_t *payload;
     uint32_t payload_len;
 
-    g_stats.total_packets++;
+    ws->total_packets++;
 
     /* Parse Ethernet */
     eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
     if (eth_hdr->ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
-        return;
+        return false;
 
     /* Parse IP */
     ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
     if (ipv4_hdr->next_proto_id != IPPROTO_UDP)
-        return;
+        return false;
 
     /* Parse UDP */
     udp_hdr = (struct rte_udp_hdr *)((uint8_t *)ipv4_hdr + sizeof(struct rte_ipv4_hdr));
@@ -664,7 +715,7 @@ static void process_packet(struct rte_mbuf *pkt)
 
     if (dst_port != QUIC_PORT_443 && dst_port != QUIC_PORT_8443 &&
         src_port != QUIC_PORT_443 && src_port != QUIC_PORT_8443)
-        return;
+        return false;
 
     /* Get payload */
     payload = (uint8_t *)(udp_hdr + 1);
@@ -672,16 +723,16 @@ static void process_packet(struct rte_mbuf *pkt)
 
     /* Verify QUIC packet */
     if (!is_quic_packet(payload, payload_len))
-        return;
+        return false;
 
-    g_stats.quic_packets++;
+    ws->quic_packets++;
 
     /* Classify packet type */
     uint8_t first_byte = payload[0];
     if (first_byte & QUIC_LONG_HEADER_BIT) {
-        g_stats.long_packets++;
+        ws->long_packets++;
     } else {
-        g_stats.short_packets++;
+        ws->short_packets++;
     }
 
     /* Classify: baseline vs attack */
@@ -692,9 +743,9 @@ static void process_packet(struct rte_mbuf *pkt)
 
     bool is_attack = false;
     if (first_octet == 192 && second_octet == 168) {
-        g_stats.baseline_packets++;
+        ws->baseline_packets++;
     } else if (first_octet == 203 && second_octet == 0 && third_octet == 113) {
-        g_stats.attack_packets++;
+        ws->attack_packets++;
         is_attack = true;
     }
 
@@ -702,12 +753,12 @@ static void process_packet(struct rte_mbuf *pkt)
     uint32_t pkt_len = rte_pktmbuf_data_len(pkt);
     if (dst_port == QUIC_PORT_443 || dst_port == QUIC_PORT_8443) {
         /* Client -> Server */
-        g_stats.total_bytes_in += pkt_len;
-        cms_update(ip_bytes_in_sketch, src_ip, pkt_len);
+        ws->total_bytes_in += pkt_len;
+        cms_update(ws->ip_bytes_in_sketch, src_ip, pkt_len);
     } else {
         /* Server -> Client */
-        g_stats.total_bytes_out += pkt_len;
-        cms_update(ip_bytes_out_sketch, src_ip, pkt_len);
+        ws->total_bytes_out += pkt_len;
+        cms_update(ws->ip_bytes_out_sketch, src_ip, pkt_len);
     }
 
     /* Parse for ACK frames */
@@ -715,40 +766,127 @@ static void process_packet(struct rte_mbuf *pkt)
     uint64_t largest_ack = 0;
     parse_quic_for_acks(payload, payload_len, &ack_count, &largest_ack);
 
-    if (ack_count > 0) {
-        g_stats.total_acks += ack_count;
+    if (ack_count == 0)
+        return false;
 
-        /* Get previous ACK count before update */
-        uint32_t prev_ack_count = cms_query(ip_ack_sketch, src_ip);
+    ws->total_acks += ack_count;
 
-        /* Update ACK count per IP */
-        cms_update(ip_ack_sketch, src_ip, ack_count);
-        uint32_t ip_ack_count = cms_query(ip_ack_sketch, src_ip);
+    /* Get previous ACK count before update */
+    uint32_t prev_ack_count = cms_query(ws->ip_ack_sketch, src_ip);
 
-        if (prev_ack_count == 0) {
-            g_stats.unique_ips++;
-        }
+    /* Update ACK count per IP */
+    cms_update(ws->ip_ack_sketch, src_ip, ack_count);
+    uint32_t ip_ack_count = cms_query(ws->ip_ack_sketch, src_ip);
 
-        /* Check for heavy hitter - only count when crossing threshold */
-        if (prev_ack_count <= HEAVY_HITTER_THRESHOLD && ip_ack_count > HEAVY_HITTER_THRESHOLD) {
-            g_stats.heavy_hitters++;
-        }
+    if (prev_ack_count == 0) {
+        ws->unique_ips++;
+    }
+
+    /* Check for heavy hitter - only count when crossing threshold */
+    if (prev_ack_count <= HEAVY_HITTER_THRESHOLD && ip_ack_count > HEAVY_HITTER_THRESHOLD) {
+        ws->heavy_hitters++;
+    }
+
+    /* Track maximum ACK rate */
+    if (ip_ack_count > ws->max_ack_rate) {
+        ws->max_ack_rate = ip_ack_count;
+    }
+
+    /* Per-IP rte_hash state is deferred to the bulk pass */
+    info->src_ip = src_ip;
+    info->pkt_len = pkt_len;
+    info->ack_count = ack_count;
+    info->largest_ack = largest_ack;
+    info->is_attack = is_attack;
+    return true;
+}
 
-        /* Track maximum ACK rate */
-        if (ip_ack_count > g_stats.max_ack_rate) {
-            g_stats.max_ack_rate = ip_ack_count;
+/* Pass 2 body: apply the ACK-rate / pkt-number-jump / burst updates to
+ * one resolved per-IP slot */
+static void update_ip_quic_state(struct worker_state *ws,
+                                 const struct quic_pkt_info *info,
+                                 struct ip_quic_stats *st)
+{
+    st->ack_count += info->ack_count;
+    st->bytes_sent += info->pkt_len;
+
+    /* Packet number jump: an optimistic ACKer acknowledges packet
+     * numbers far ahead of what it last acknowledged */
+    if (info->largest_ack > 0) {
+        if (st->last_pkt_num > 0 && info->largest_ack > st->last_pkt_num) {
+            uint64_t jump = info->largest_ack - st->last_pkt_num;
+            if (jump > st->max_pkt_num_jump)
+                st->max_pkt_num_jump = jump;
+
+            if (info->is_attack && jump > PKT_NUM_JUMP_THRESHOLD) {
+                ws->suspicious_ips++;
+                if (jump > ws->max_pkt_num_jump)
+                    ws->max_pkt_num_jump = jump;
+            }
         }
+        st->last_pkt_num = info->largest_ack;
+    }
 
-        /* Check for suspicious packet number jumps */
-        if (largest_ack > 0 && is_attack) {
-            /* This would need per-IP state to properly track jumps */
-            /* Simplified: count large packet numbers as suspicious */
-            if (largest_ack > PKT_NUM_JUMP_THRESHOLD) {
-                g_stats.suspicious_ips++;
-                if (largest_ack > g_stats.max_pkt_num_jump) {
-                    g_stats.max_pkt_num_jump = largest_ack;
-                }
+    /* Burst detection: >BURST_THRESHOLD ACKs within 100ms */
+    uint64_t cur_tsc = rte_rdtsc();
+    if (cur_tsc - st->last_burst_check > rte_get_tsc_hz() / 10) {
+        st->burst_count = 0;
+        st->last_burst_check = cur_tsc;
+    }
+    st->burst_count += info->ack_count;
+    if (st->burst_count > BURST_THRESHOLD) {
+        ws->burst_detections++;
+        st->burst_count = 0;
+    }
+}
+
+/* Process one RX burst in two passes: parse everything first, then
+ * resolve all per-IP slots with one rte_hash_lookup_bulk() per chunk
+ * (hash probes overlap instead of serializing 512 dependent
+ * hash+probe+load chains), prefetch the slots, and apply the updates */
+static void process_burst(struct worker_state *ws, struct rte_mbuf **bufs,
+                          uint16_t nb_rx)
+{
+    struct quic_pkt_info infos[BURST_SIZE];
+    const void *keys[RTE_HASH_LOOKUP_BULK_MAX];
+    int32_t positions[RTE_HASH_LOOKUP_BULK_MAX];
+    uint16_t nb_acked = 0;
+
+    for (uint16_t i = 0; i < nb_rx; i++) {
+        if (process_packet_parse(ws, bufs[i], &infos[nb_acked]))
+            nb_acked++;
+        rte_pktmbuf_free(bufs[i]);
+    }
+
+    for (uint16_t base = 0; base < nb_acked;
+         base += RTE_HASH_LOOKUP_BULK_MAX) {
+        uint16_t n = nb_acked - base;
+        if (n > RTE_HASH_LOOKUP_BULK_MAX)
+            n = RTE_HASH_LOOKUP_BULK_MAX;
+
+        for (uint16_t j = 0; j < n; j++)
+            keys[j] = &infos[base + j].src_ip;
+
+        rte_hash_lookup_bulk(ws->ip_hash, keys, n, positions);
+
+        /* Resolve misses (new IPs) and prefetch every slot before the
+         * update pass touches it */
+        for (uint16_t j = 0; j < n; j++) {
+            if (positions[j] < 0) {
+                positions[j] = rte_hash_add_key(ws->ip_hash, keys[j]);
+                if (positions[j] >= 0)
+                    memset(&ws->ip_stats[positions[j]], 0,
+                           sizeof(struct ip_quic_stats));
             }
+            if (positions[j] >= 0)
+                rte_prefetch0(&ws->ip_stats[positions[j]]);
+        }
+
+        for (uint16_t j = 0; j < n; j++) {
+            if (positions[j] < 0)
+                continue;  /* Partition full - skip per-IP tracking */
+            update_ip_quic_state(ws, &infos[base + j],
+                                 &ws->ip_stats[positions[j]]);
         }
     }
 }
@@ -791,13 +929,35 @@ static void print_stats(void)
 
     if (window_duration >= 0.001) {
         g_stats.instantaneous_throughput_gbps = (bytes_in_window * 8.0) / (window_duration * 1e9);
-        g_stats.throughput_per_core_gbps = g_stats.instantaneous_throughput_gbps;
+        g_stats.throughput_per_core_gbps = g_stats.instantaneous_throughput_gbps / NUM_RX_QUEUES;
     }
 
     /* Update window tracking */
     g_stats.window_bytes_in_prev = g_stats.total_bytes_in;
     g_stats.window_bytes_out_prev = g_stats.total_bytes_out;
 
+    /* Publish the interval snapshot to the binary telemetry ring.
+     * aux[]: QUIC pkts, total ACKs, bytes in/out, suspicious IPs, bursts */
+    struct telemetry_record trec = {0};
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    trec.tsc = cur_tsc;
+    trec.wall_ns = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+    trec.alert_level = g_stats.alert_level;
+    trec.total_packets = g_stats.total_packets;
+    trec.total_bytes = g_stats.total_bytes_in + g_stats.total_bytes_out;
+    trec.baseline_packets = g_stats.baseline_packets;
+    trec.attack_packets = g_stats.attack_packets;
+    trec.nic_rx_dropped = g_stats.rx_dropped_nic;
+    trec.throughput_gbps = g_stats.instantaneous_throughput_gbps;
+    trec.aux[0] = (double)g_stats.quic_packets;
+    trec.aux[1] = (double)g_stats.total_acks;
+    trec.aux[2] = (double)g_stats.total_bytes_in;
+    trec.aux[3] = (double)g_stats.total_bytes_out;
+    trec.aux[4] = (double)g_stats.suspicious_ips;
+    trec.aux[5] = (double)g_stats.burst_detections;
+    telemetry_publish(&g_telemetry, &trec);
+
     dual_printf("\n");
     dual_printf("╔═══════════════════════════════════════════════════════════════════════╗\n");
     dual_printf("║          QUIC OPTIMISTIC ACK DETECTOR - STATISTICS                   ║\n");
@@ -890,6 +1050,7 @@ static void print_stats(void)
         /* Metric 5: Performance */
         dual_printf("\n[PERFORMANCE METRICS]\n");
         dual_printf("  Detection granularity: 100ms\n");
+        dual_printf("  Workers:              %d (RSS)\n", NUM_RX_QUEUES);
         dual_printf("  Cycles/packet:        %.0f cycles\n", g_stats.cycles_per_packet);
         dual_printf("  Throughput/core:      %.2f Gbps\n", g_stats.throughput_per_core_gbps);
         dual_printf("  Processing:           %sLine-rate capable%s\n",
@@ -964,16 +1125,22 @@ static void print_stats(void)
     dual_printf("\n");
 }
 
-/* Port initialization */
+/* Port initialization with multi-queue RSS (same setup as MIRA) */
 static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
 {
     struct rte_eth_conf port_conf = {
         .rxmode = {
-            .mq_mode = ETH_MQ_RX_NONE,
+            .mq_mode = ETH_MQ_RX_RSS,  /* Enable RSS */
+        },
+        .rx_adv_conf = {
+            .rss_conf = {
+                .rss_key = NULL,  /* Use default key */
+                .rss_hf = ETH_RSS_IP | ETH_RSS_UDP,  /* Hash on IP + UDP ports */
+            },
         },
     };
 
-    const uint16_t rx_rings = 1, tx_rings = 0;
+    const uint16_t rx_rings = NUM_RX_QUEUES, tx_rings = 0;
     uint16_t nb_rxd = RX_RING_SIZE;
     int retval;
     struct rte_eth_dev_info dev_info;
@@ -993,7 +1160,7 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     if (retval != 0)
         return retval;
 
-    /* Setup RX queue */
+    /* Setup RX queues - one per worker */
     for (uint16_t q = 0; q < rx_rings; q++) {
         retval = rte_eth_rx_queue_setup(port, q, nb_rxd,
                 rte_eth_dev_socket_id(port), NULL, mbuf_pool);
@@ -1012,44 +1179,56 @@ static int port_init(uint16_t port, struct rte_mempool *mbuf_pool)
     return 0;
 }
 
-/* Main detection loop */
-static int detection_loop(__rte_unused void *arg)
+/* Worker thread - RX + frame parsing for one RSS queue */
+static int worker_thread(void *arg)
 {
-    unsigned lcore_id = rte_lcore_id();
+    uint16_t queue_id = *(uint16_t *)arg;
     uint16_t port = g_config.port_id;
+    struct worker_state *ws = &g_workers[queue_id];
     struct rte_mbuf *bufs[BURST_SIZE];
 
-    printf("Detection loop started on lcore %u\n", lcore_id);
-
-    g_stats.window_start_tsc = rte_rdtsc();
-    g_stats.last_stats_tsc = rte_rdtsc();
+    printf("Worker thread %u processing queue %u on lcore %u\n",
+           queue_id, queue_id, rte_lcore_id());
 
     while (!force_quit) {
-        uint16_t nb_rx = rte_eth_rx_burst(port, 0, bufs, BURST_SIZE);
+        uint16_t nb_rx = rte_eth_rx_burst(port, queue_id, bufs, BURST_SIZE);
 
         /* Track RX burst statistics */
-        g_stats.rx_bursts_total++;
+        ws->rx_bursts_total++;
         if (unlikely(nb_rx == 0)) {
-            g_stats.rx_bursts_empty++;
+            ws->rx_bursts_empty++;
             continue;
         }
 
         /* TMA 2025 Metric: Measure CPU cycles for packet processing */
         uint64_t start_tsc = rte_rdtsc();
 
-        for (uint16_t i = 0; i < nb_rx; i++) {
-            process_packet(bufs[i]);
-            rte_pktmbuf_free(bufs[i]);
-        }
+        process_burst(ws, bufs, nb_rx);
 
         uint64_t end_tsc = rte_rdtsc();
-        g_stats.total_processing_cycles += (end_tsc - start_tsc);
+        ws->total_processing_cycles += (end_tsc - start_tsc);
+    }
+
+    return 0;
+}
 
-        /* Run detection */
+/* Coordinator thread - detection rules and stats */
+static int coordinator_thread(__rte_unused void *arg)
+{
+    printf("\nCoordinator thread on lcore %u\n", rte_lcore_id());
+
+    g_stats.window_start_tsc = rte_rdtsc();
+    g_stats.last_stats_tsc = rte_rdtsc();
+    g_stats.last_fast_detection_tsc = rte_rdtsc();
+
+    while (!force_quit) {
+        /* Run detection (aggregates workers internally) */
         detect_optimistic_ack();
 
         /* Print stats */
         print_stats();
+
+        rte_delay_us_block(10000);  /* 10ms sleep */
     }
 
     return 0;
@@ -1059,6 +1238,7 @@ static int detection_loop(__rte_unused void *arg)
 int main(int argc, char **argv)
 {
     int ret;
+    static uint16_t queue_ids[NUM_RX_QUEUES];
 
     /* Initialize EAL */
     ret = rte_eal_init(argc, argv);
@@ -1079,6 +1259,11 @@ int main(int argc, char **argv)
 
     printf("Found %u Ethernet port(s)\n", nb_ports);
 
+    /* Need 14 workers + 1 coordinator + main lcore */
+    if (rte_lcore_count() < NUM_RX_QUEUES + 2)
+        rte_exit(EXIT_FAILURE, "Need at least %d lcores (%d workers + coordinator + main)\n",
+                 NUM_RX_QUEUES + 2, NUM_RX_QUEUES);
+
     /* Create mbuf pool */
     mbuf_pool = rte_pktmbuf_pool_create("MBUF_POOL", NUM_MBUFS,
             MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
@@ -1086,21 +1271,47 @@ int main(int argc, char **argv)
     if (mbuf_pool == NULL)
         rte_exit(EXIT_FAILURE, "Cannot create mbuf pool\n");
 
-    /* Initialize sketches */
-    ip_ack_sketch = cms_init(SKETCH_WIDTH, SKETCH_DEPTH);
-    ip_bytes_in_sketch = cms_init(SKETCH_WIDTH, SKETCH_DEPTH);
-    ip_bytes_out_sketch = cms_init(SKETCH_WIDTH, SKETCH_DEPTH);
-
-    if (!ip_ack_sketch || !ip_bytes_in_sketch || !ip_bytes_out_sketch)
-        rte_exit(EXIT_FAILURE, "Cannot create sketches\n");
+    /* Initialize per-worker sketches and per-IP state partitions */
+    memset(g_workers, 0, sizeof(g_workers));
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        struct worker_state *ws = &g_workers[w];
+
+        ws->ip_ack_sketch = cms_init();
+        ws->ip_bytes_in_sketch = cms_init();
+        ws->ip_bytes_out_sketch = cms_init();
+
+        if (!ws->ip_ack_sketch || !ws->ip_bytes_in_sketch || !ws->ip_bytes_out_sketch)
+            rte_exit(EXIT_FAILURE, "Cannot create sketches for worker %d\n", w);
+
+        char hash_name[32];
+        snprintf(hash_name, sizeof(hash_name), "quic_ip_hash_%d", w);
+        struct rte_hash_parameters hash_params = {
+            .name = hash_name,
+            .entries = MAX_IPS_PER_WORKER,
+            .key_len = sizeof(uint32_t),
+            .hash_func = rte_jhash,
+            .hash_func_init_val = 0,
+            .socket_id = rte_socket_id(),
+        };
+        ws->ip_hash = rte_hash_create(&hash_params);
+        if (ws->ip_hash == NULL)
+            rte_exit(EXIT_FAILURE, "Cannot create IP hash for worker %d\n", w);
+
+        ws->ip_stats = rte_zmalloc(NULL,
+                MAX_IPS_PER_WORKER * sizeof(struct ip_quic_stats),
+                RTE_CACHE_LINE_SIZE);
+        if (ws->ip_stats == NULL)
+            rte_exit(EXIT_FAILURE, "Cannot allocate IP stats for worker %d\n", w);
+    }
 
-    printf("OctoSketch initialized: %ux%u (3 sketches)\n", SKETCH_WIDTH, SKETCH_DEPTH);
+    printf("OctoSketch initialized: %ux%u (3 sketches) x %d workers\n",
+           CMS_WIDTH, CMS_DEPTH, NUM_RX_QUEUES);
 
     /* Initialize port */
     if (port_init(g_config.port_id, mbuf_pool) != 0)
         rte_exit(EXIT_FAILURE, "Cannot init port %u\n", g_config.port_id);
 
-    printf("Port %u initialized\n", g_config.port_id);
+    printf("Port %u initialized with %d RSS queues\n", g_config.port_id, NUM_RX_QUEUES);
 
     /* Initialize stats */
     memset(&g_stats, 0, sizeof(g_stats));
@@ -1108,11 +1319,17 @@ int main(int argc, char **argv)
     /* Open log file */
     open_log_file();
 
+    /* Binary telemetry ring next to the text log */
+    telemetry_open(&g_telemetry,
+                   "/local/dpdk_100g/quic/results/quic_telemetry.bin",
+                   "quic_optimistic_ack_detector");
+
     dual_printf("\n");
     dual_printf("╔═══════════════════════════════════════════════════════════════════════╗\n");
     dual_printf("║      QUIC OPTIMISTIC ACK DETECTOR - DPDK + OctoSketch                ║\n");
     dual_printf("╠═══════════════════════════════════════════════════════════════════════╣\n");
     dual_printf("║  Port:              %u                                                ║\n", g_config.port_id);
+    dual_printf("║  Workers:           %u (RSS) + 1 coordinator                         ║\n", NUM_RX_QUEUES);
     dual_printf("║  Detection window:  %u second                                         ║\n", DETECTION_WINDOW_SEC);
     dual_printf("║  Stats interval:    %u seconds                                        ║\n", STATS_INTERVAL_SEC);
     dual_printf("║                                                                       ║\n");
@@ -1125,17 +1342,53 @@ int main(int argc, char **argv)
     dual_printf("╚═══════════════════════════════════════════════════════════════════════╝\n");
     dual_printf("\nPress Ctrl+C to exit...\n\n");
 
-    /* Run detection */
-    detection_loop(NULL);
+    /* Launch workers on the first NUM_RX_QUEUES slave lcores and the
+     * coordinator on the next one (same scheme as MIRA) */
+    for (unsigned i = 0; i < NUM_RX_QUEUES; i++) {
+        queue_ids[i] = i;
+    }
+
+    unsigned lcore_id;
+    unsigned lcore_idx = 0;
+    unsigned coordinator_lcore = 0;
+
+    RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+        if (lcore_idx < NUM_RX_QUEUES) {
+            printf("Launching worker %u on lcore %u\n", lcore_idx, lcore_id);
+            rte_eal_remote_launch(worker_thread, &queue_ids[lcore_idx], lcore_id);
+            lcore_idx++;
+        } else {
+            coordinator_lcore = lcore_id;
+            break;
+        }
+    }
+
+    if (coordinator_lcore > 0) {
+        printf("Launching coordinator on lcore %u\n", coordinator_lcore);
+        rte_eal_remote_launch(coordinator_thread, NULL, coordinator_lcore);
+    } else {
+        printf("Warning: No lcore available for coordinator thread!\n");
+    }
+
+    /* Wait for all threads */
+    rte_eal_mp_wait_lcore();
 
     /* Final stats */
     printf("\n\n=== FINAL STATISTICS ===\n");
+    aggregate_worker_stats();
     print_stats();
 
     /* Cleanup */
-    cms_free(ip_ack_sketch);
-    cms_free(ip_bytes_in_sketch);
-    cms_free(ip_bytes_out_sketch);
+    telemetry_close(&g_telemetry);
+    for (int w = 0; w < NUM_RX_QUEUES; w++) {
+        cms_free(g_workers[w].ip_ack_sketch);
+        cms_free(g_workers[w].ip_bytes_in_sketch);
+        cms_free(g_workers[w].ip_bytes_out_sketch);
+        rte_hash_free(g_workers[w].ip_hash);
+        rte_free(g_workers[w].ip_stats);
+    }
+
+    close_log_file();
 
     printf("\nDetector stopped.\n");
 